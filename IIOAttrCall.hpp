@@ -0,0 +1,90 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <cctype>
+#include <string>
+
+/*!
+ * IIOAttrCall parses the names of the per-attribute calls exposed by the IIO
+ * blocks, so that they can be bound on first use rather than for every
+ * attribute when a block is constructed:
+ *
+ *     deviceAttribute[attr]           setdeviceAttribute[attr]
+ *     channelAttribute[chan][attr]    setChannelAttribute[chan][attr]
+ *
+ * and the probe slots of the getters, such as probeDeviceAttribute[attr].
+ * The probe slots themselves are registered with the block, from the
+ * attribute names, so that topologies can connect to them up front.
+ */
+struct IIOAttrCall
+{
+    enum Kind
+    {
+        None,
+        DeviceGet,
+        DeviceSet,
+        ChannelGet,
+        ChannelSet,
+    };
+
+    Kind kind;
+    bool probe;
+    std::string channel;
+    std::string attr;
+
+    IIOAttrCall(void) : kind(None), probe(false) {}
+
+    static IIOAttrCall parse(std::string name)
+    {
+        IIOAttrCall call;
+        if (name.compare(0, 5, "probe") == 0 && name.size() > 5)
+        {
+            call.probe = true;
+            name = name.substr(5);
+            name[0] = std::tolower(name[0]);
+        }
+
+        //split off the bracketed arguments
+        const auto open = name.find('[');
+        if (open == std::string::npos || name.back() != ']')
+            return IIOAttrCall();
+        const std::string base = name.substr(0, open);
+        const std::string args = name.substr(open + 1, name.size() - open - 2);
+        const auto sep = args.find("][");
+
+        if (sep == std::string::npos && args.find(']') == std::string::npos)
+        {
+            if (base == "deviceAttribute") call.kind = DeviceGet;
+            else if (base == "setdeviceAttribute") call.kind = DeviceSet;
+            call.attr = args;
+        }
+        else if (sep != std::string::npos && args.find(']', sep + 2) == std::string::npos)
+        {
+            if (base == "channelAttribute") call.kind = ChannelGet;
+            else if (base == "setChannelAttribute") call.kind = ChannelSet;
+            call.channel = args.substr(0, sep);
+            call.attr = args.substr(sep + 2);
+        }
+
+        //only getters have probes
+        if (call.probe && call.kind != DeviceGet && call.kind != ChannelGet)
+            return IIOAttrCall();
+        return call;
+    }
+
+    /*!
+     * Get the name of the call itself, without any probe prefix.
+     */
+    std::string name(void) const
+    {
+        switch (this->kind)
+        {
+            case DeviceGet: return "deviceAttribute[" + this->attr + "]";
+            case DeviceSet: return "setdeviceAttribute[" + this->attr + "]";
+            case ChannelGet: return "channelAttribute[" + this->channel + "][" + this->attr + "]";
+            case ChannelSet: return "setChannelAttribute[" + this->channel + "][" + this->attr + "]";
+            default: return "";
+        }
+    }
+};
@@ -0,0 +1,535 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <poll.h>
+#include <time.h>
+#include <algorithm>
+#include "IIOBlock.hpp"
+#include "IIOProfile.hpp"
+#include "IIOModes.hpp"
+#include "IIOClock.hpp"
+#include "IIOCalibration.hpp"
+
+#include <json.hpp>
+using json = nlohmann::json;
+
+static std::string constraintJSON(const IIOAttrConstraint &constraint)
+{
+    json obj;
+    switch (constraint.kind())
+    {
+        case IIOAttrConstraint::Range:
+            obj["type"] = "range";
+            obj["min"] = constraint.min();
+            obj["step"] = constraint.step();
+            obj["max"] = constraint.max();
+            break;
+        case IIOAttrConstraint::List:
+            obj["type"] = "list";
+            obj["options"] = constraint.options();
+            break;
+        default:
+            obj["type"] = "none";
+            break;
+    }
+    return obj.dump();
+}
+
+IIOBlock::IIOBlock(const std::string &className, const std::string &deviceId, const std::vector<std::string> &channelIds,
+    const bool enablePorts, const size_t bufferSize, const bool output)
+    : className(className), enablePorts(enablePorts), bufferSize(bufferSize)
+{
+    this->hookLayout.output = output;
+
+    //expose overlay hook
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, overlay));
+
+    //expose attribute access by name
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, deviceAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, setDeviceAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, channelAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, setChannelAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, deviceAttributeData));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, loadDeviceAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, channelAttributeData));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, loadChannelAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, deviceAttributeConstraint));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, channelAttributeConstraint));
+
+    //expose debug register access
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, regRead));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, regWrite));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, regReadBatch));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, regWriteBatch));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, debugAttributeNames));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, debugAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, setDebugAttribute));
+
+    //expose attribute profiles
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, saveProfile));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, loadProfile));
+
+    //expose attribute change notification
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, watchDeviceAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, watchChannelAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, unwatchDeviceAttribute));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, unwatchChannelAttribute));
+    this->registerSignal("attributeChanged");
+
+    //expose buffer hooks, recovery and calibration
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, setBufferHook));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, setRecoveryAttempts));
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, recoveries));
+    this->registerProbe("recoveries");
+    this->registerCall(this, POTHOS_FCN_TUPLE(IIOBlock, calibrate));
+
+    //get libiio context
+    IIOContext& ctx = IIOContext::get();
+
+    //if deviceId is blank, create a partial object that exposes the
+    //overlay hook for the gui but cannot be activated
+    if (deviceId == "") {
+        return;
+    }
+
+    //find iio device
+    for (auto d : ctx.devices())
+    {
+        if (d.id() == deviceId)
+        {
+            this->dev = std::unique_ptr<IIODevice>(new IIODevice(d));
+            break;
+        }
+    }
+    if (!this->dev)
+    {
+        throw Pothos::SystemException(this->className + "::" + this->className + "()", "device not found");
+    }
+
+    //select channels in the direction of the stream
+    for (auto c : this->dev->channels())
+    {
+        if (c.isOutput() != output)
+            continue;
+        std::string cId = c.id();
+        if (channelIds.size() > 0 && std::none_of(channelIds.begin(), channelIds.end(),
+                [cId](std::string s){ return s == cId; }))
+            continue;
+        this->channels.push_back(c);
+    }
+
+    this->registerAttributeProbes();
+}
+
+std::string IIOBlock::overlay(void) const
+{
+    IIOContext& ctx = IIOContext::get();
+
+    json topObj;
+    auto &params = topObj["params"];
+
+    //configure deviceId dropdown options
+    json deviceIdParam;
+    deviceIdParam["key"] = "deviceId";
+    auto &deviceIdOpts = deviceIdParam["options"];
+    deviceIdParam["widgetKwargs"]["editable"] = false;
+    deviceIdParam["widgetType"] = "DropDown";
+
+    //add empty device option associated
+    json emptyOption;
+    emptyOption["name"] = "";
+    emptyOption["value"] = "\"\"";
+    deviceIdOpts.push_back(emptyOption);
+
+    //enumerate iio devices
+    for (auto d : ctx.devices())
+    {
+        json option;
+        option["name"] = d.name() + " (" + d.id() + ")";
+        option["value"] = "\"" + d.id() + "\"";
+        deviceIdOpts.push_back(option);
+    }
+    params.push_back(deviceIdParam);
+
+    return topObj.dump();
+}
+
+std::string IIOBlock::deviceAttribute(const std::string &name)
+{
+    return this->findDevice().attributes().at(name).value();
+}
+
+void IIOBlock::setDeviceAttribute(const std::string &name, const Pothos::Object &value)
+{
+    this->findDevice().attributes().at(name) = value.toString();
+}
+
+std::string IIOBlock::channelAttribute(const std::string &channel, const std::string &name)
+{
+    return this->findChannel(channel).attributes().at(name).value();
+}
+
+void IIOBlock::setChannelAttribute(const std::string &channel, const std::string &name, const Pothos::Object &value)
+{
+    this->findChannel(channel).attributes().at(name) = value.toString();
+}
+
+std::string IIOBlock::deviceAttributeData(const std::string &name)
+{
+    return this->findDevice().attributes().at(name).data();
+}
+
+void IIOBlock::loadDeviceAttribute(const std::string &name, const std::string &path)
+{
+    this->findDevice().attributes().at(name).load(path);
+}
+
+std::string IIOBlock::channelAttributeData(const std::string &channel, const std::string &name)
+{
+    return this->findChannel(channel).attributes().at(name).data();
+}
+
+void IIOBlock::loadChannelAttribute(const std::string &channel, const std::string &name, const std::string &path)
+{
+    this->findChannel(channel).attributes().at(name).load(path);
+}
+
+std::string IIOBlock::deviceAttributeConstraint(const std::string &name)
+{
+    return constraintJSON(this->findDevice().attributes().at(name).constraint());
+}
+
+std::string IIOBlock::channelAttributeConstraint(const std::string &channel, const std::string &name)
+{
+    return constraintJSON(this->findChannel(channel).attributes().at(name).constraint());
+}
+
+uint32_t IIOBlock::regRead(const uint32_t address)
+{
+    return this->findDevice().regRead(address);
+}
+
+void IIOBlock::regWrite(const uint32_t address, const uint32_t value)
+{
+    this->findDevice().regWrite(address, value);
+}
+
+std::vector<uint32_t> IIOBlock::regReadBatch(const std::vector<uint32_t> &addresses)
+{
+    return this->findDevice().regRead(addresses);
+}
+
+void IIOBlock::regWriteBatch(const std::vector<uint32_t> &addresses, const std::vector<uint32_t> &values)
+{
+    this->findDevice().regWrite(addresses, values);
+}
+
+std::vector<std::string> IIOBlock::debugAttributeNames(void)
+{
+    std::vector<std::string> names;
+    for (auto a : this->findDevice().debugAttributes()) names.push_back(a.name());
+    return names;
+}
+
+std::string IIOBlock::debugAttribute(const std::string &name)
+{
+    return this->findDevice().debugAttributes().at(name).value();
+}
+
+void IIOBlock::setDebugAttribute(const std::string &name, const Pothos::Object &value)
+{
+    this->findDevice().debugAttributes().at(name) = value.toString();
+}
+
+std::string IIOBlock::saveProfile(const std::string &path)
+{
+    return IIOProfile::save(this->findDevice(), path);
+}
+
+size_t IIOBlock::loadProfile(const std::string &path)
+{
+    return IIOProfile::load(this->findDevice(), path);
+}
+
+void IIOBlock::watchDeviceAttribute(const std::string &name)
+{
+    IIOAttrCall call;
+    call.kind = IIOAttrCall::DeviceGet;
+    call.attr = name;
+    this->attrWatcher().watch(call.name(), this->findDevice().attributes(), name);
+}
+
+void IIOBlock::watchChannelAttribute(const std::string &channel, const std::string &name)
+{
+    IIOAttrCall call;
+    call.kind = IIOAttrCall::ChannelGet;
+    call.channel = channel;
+    call.attr = name;
+    this->attrWatcher().watch(call.name(), this->findChannel(channel).attributes(), name);
+}
+
+void IIOBlock::unwatchDeviceAttribute(const std::string &name)
+{
+    IIOAttrCall call;
+    call.kind = IIOAttrCall::DeviceGet;
+    call.attr = name;
+    if (this->watcher) this->watcher->unwatch(call.name());
+}
+
+void IIOBlock::unwatchChannelAttribute(const std::string &channel, const std::string &name)
+{
+    IIOAttrCall call;
+    call.kind = IIOAttrCall::ChannelGet;
+    call.channel = channel;
+    call.attr = name;
+    if (this->watcher) this->watcher->unwatch(call.name());
+}
+
+void IIOBlock::setBufferHook(const std::string &name, const std::string &args)
+{
+    this->hook.reset();
+    if (!name.empty()) this->hook = IIOBufferHook::load(name, args);
+}
+
+void IIOBlock::setRecoveryAttempts(const size_t attempts)
+{
+    this->recovery.setMaxAttempts(attempts);
+}
+
+unsigned long long IIOBlock::recoveries(void) const
+{
+    return this->recovery.recoveries();
+}
+
+std::string IIOBlock::calibrate(void)
+{
+    if (!this->dev || this->isActive())
+    {
+        throw Pothos::IllegalStateException(this->className + "::calibrate()", "calibration needs an idle device");
+    }
+    return IIOCalibration().run(*this->dev, this->channels, this->calibrationSampleRate());
+}
+
+Pothos::Object IIOBlock::opaqueCallHandler(const std::string &name, const Pothos::Object *inputArgs, const size_t numArgs)
+{
+    //per-attribute calls are bound when first used
+    if (!name.empty() && name.back() == ']' && this->attrCalls.count(name) == 0)
+    {
+        this->registerAttributeCall(IIOAttrCall::parse(name));
+        this->attrCalls.insert(name);
+    }
+    return Pothos::Block::opaqueCallHandler(name, inputArgs, numArgs);
+}
+
+IIODevice &IIOBlock::findDevice(void)
+{
+    if (!this->dev)
+    {
+        throw Pothos::SystemException(this->className + "::findDevice()", "no device specified");
+    }
+    return *this->dev;
+}
+
+IIOChannel IIOBlock::findChannel(const std::string &id)
+{
+    for (auto c : this->channels)
+    {
+        if (c.id() == id) return c;
+    }
+    throw Pothos::NotFoundException(this->className + "::findChannel()", "channel not found: " + id);
+}
+
+bool IIOBlock::haveScanElements(void)
+{
+    return std::any_of(this->channels.begin(), this->channels.end(),
+        [](IIOChannel c){ return c.isScanElement(); });
+}
+
+void IIOBlock::createBuffer(void)
+{
+    if (!this->dev)
+    {
+        throw Pothos::SystemException(this->className + "::activate()", "no device specified");
+    }
+
+    this->buf.reset();
+    for (auto c : this->channels) c.enable();
+
+    //create sample buffer if we've got any scan elements
+    if (this->haveScanElements() && this->enablePorts) {
+        this->buf = std::unique_ptr<IIOBuffer>(new IIOBuffer(std::move(this->dev->createBuffer(this->bufferSize, false))));
+        if (!this->buf)
+        {
+            throw Pothos::SystemException(this->className + "::activate()", "buffer creation failed");
+        }
+        this->buf->setBlockingMode(false);
+        this->hookLayout.channels = iioScanLayout(*this->buf, this->channels);
+    }
+}
+
+void IIOBlock::runHook(size_t count, unsigned long long sampleIndex, long long timeNs)
+{
+    if (!this->hook)
+        return;
+    this->hookLayout.start = this->buf->start();
+    this->hookLayout.count = count;
+    this->hookLayout.step = this->buf->step();
+    this->hookLayout.sampleIndex = sampleIndex;
+    this->hookLayout.timeNs = timeNs;
+    this->hook->process(this->hookLayout);
+}
+
+bool IIOBlock::recoverBuffer(void)
+{
+    const long long nowNs = IIOClockCorrelator::now();
+    const long long waitNs = this->recovery.waitNs(nowNs);
+    if (waitNs > 0)
+    {
+        this->waitUntil(nowNs + waitNs);
+        return false;
+    }
+
+    //the old buffer is released before a new one is requested
+    try
+    {
+        this->buf.reset(new IIOBuffer(std::move(this->dev->createBuffer(this->bufferSize, false))));
+        this->buf->setBlockingMode(false);
+    }
+    catch (const Pothos::Exception &ex)
+    {
+        this->buf.reset();
+        this->recovery.failed(ex, nowNs);
+        this->yield();
+        return false;
+    }
+    this->recovery.succeeded();
+    return true;
+}
+
+void IIOBlock::waitUntil(const long long deadlineNs)
+{
+    const long long waitNs = std::min(deadlineNs - IIOClockCorrelator::now(), this->workInfo().maxTimeoutNs);
+    if (waitNs > 0)
+    {
+        struct timespec ts = {
+            .tv_sec = static_cast<time_t>(waitNs / 1000000000),
+            .tv_nsec = static_cast<long int>(waitNs % 1000000000)
+        };
+        ppoll(NULL, 0, &ts, NULL);
+    }
+    this->yield();
+}
+
+void IIOBlock::emitAttributeChanges(void)
+{
+    std::vector<std::pair<std::string, std::string>> changes;
+    {
+        std::lock_guard<std::mutex> lock(this->attrChangesMutex);
+        if (this->attrChanges.empty())
+            return;
+        changes.swap(this->attrChanges);
+    }
+    for (const auto &c : changes)
+    {
+        this->emitSignal("attributeChanged", c.first, c.second);
+    }
+}
+
+double IIOBlock::calibrationSampleRate(void)
+{
+    return 0.0;
+}
+
+IIOAttrWatcher &IIOBlock::attrWatcher(void)
+{
+    //the watcher thread only queues changes, since signals may only be
+    //emitted from the block's own context; it is started once needed.
+    //a change replaces any queued change of the same attribute, so the
+    //queue holds at most one entry per watched attribute while work()
+    //is not being called
+    if (!this->watcher)
+    {
+        this->watcher.reset(new IIOAttrWatcher([this](const std::string &key, const std::string &value)
+        {
+            std::lock_guard<std::mutex> lock(this->attrChangesMutex);
+            for (auto &c : this->attrChanges)
+            {
+                if (c.first == key)
+                {
+                    c.second = value;
+                    return;
+                }
+            }
+            this->attrChanges.push_back(std::make_pair(key, value));
+        }));
+    }
+    return *this->watcher;
+}
+
+void IIOBlock::registerAttributeCall(const IIOAttrCall &call)
+{
+    if (call.kind == IIOAttrCall::None)
+        return;
+
+    //the getter must exist before its probe
+    const auto callName = call.name();
+    if (this->attrCalls.count(callName) == 0)
+    {
+        Pothos::Callable callable;
+        switch (call.kind)
+        {
+            case IIOAttrCall::DeviceGet:
+                callable = Pothos::Callable(&IIOBlock::deviceAttribute).bind(std::ref(*this), 0).bind(call.attr, 1);
+                break;
+            case IIOAttrCall::DeviceSet:
+                callable = Pothos::Callable(&IIOBlock::setDeviceAttribute).bind(std::ref(*this), 0).bind(call.attr, 1);
+                break;
+            case IIOAttrCall::ChannelGet:
+                callable = Pothos::Callable(&IIOBlock::channelAttribute).bind(std::ref(*this), 0).bind(call.channel, 1).bind(call.attr, 2);
+                break;
+            default:
+                callable = Pothos::Callable(&IIOBlock::setChannelAttribute).bind(std::ref(*this), 0).bind(call.channel, 1).bind(call.attr, 2);
+                break;
+        }
+        this->registerCallable(callName, callable);
+        this->attrCalls.insert(callName);
+    }
+    if (call.probe)
+    {
+        this->registerAttributeCallProbe(call);
+    }
+}
+
+void IIOBlock::registerAttributeProbes(void)
+{
+    //probe slots and signals must exist before a topology connects to
+    //them, and only need the attribute names, so they are registered up
+    //front while their getters are bound on first use
+    IIOAttrCall call;
+    call.probe = true;
+    call.kind = IIOAttrCall::DeviceGet;
+    for (auto a : this->dev->attributes())
+    {
+        call.attr = a.name();
+        this->registerAttributeCallProbe(call);
+    }
+    call.kind = IIOAttrCall::ChannelGet;
+    for (auto c : this->channels)
+    {
+        call.channel = c.id();
+        for (auto a : c.attributes())
+        {
+            call.attr = a.name();
+            this->registerAttributeCallProbe(call);
+        }
+    }
+}
+
+void IIOBlock::registerAttributeCallProbe(const IIOAttrCall &call)
+{
+    const auto callName = call.name();
+    if (this->attrProbes.count(callName) != 0)
+        return;
+    this->registerProbe(callName);
+    this->attrProbes.insert(callName);
+}
@@ -0,0 +1,152 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "IIOSupport.hpp"
+#include "IIOAttrCall.hpp"
+#include "IIOWatcher.hpp"
+#include "IIOBufferHook.hpp"
+#include "IIORecovery.hpp"
+
+/*!
+ * IIOBlock is the common base of the IIO source and sink. It finds the
+ * device and selects its channels, and exposes everything which does not
+ * depend on the direction of the stream: attribute, register and debug
+ * attribute access, attribute constraints, profiles, attribute watching,
+ * buffer hooks, buffer recovery and calibration. The blocks only add their
+ * ports and move samples between them and the buffer.
+ *
+ * The calls are registered by the constructor under the names documented
+ * by the blocks, with errors reported as coming from the block's class.
+ */
+class IIOBlock : public Pothos::Block
+{
+public:
+    /*!
+     * Find the device and select the listed channels, or all of them when
+     * none are listed, among its output channels when output is true and
+     * its input channels otherwise. If deviceId is empty, the block only
+     * exposes the overlay for the GUI and cannot be activated.
+     */
+    IIOBlock(const std::string &className, const std::string &deviceId, const std::vector<std::string> &channelIds,
+        const bool enablePorts, const size_t bufferSize, const bool output);
+
+    std::string overlay(void) const;
+
+    std::string deviceAttribute(const std::string &name);
+    void setDeviceAttribute(const std::string &name, const Pothos::Object &value);
+    std::string channelAttribute(const std::string &channel, const std::string &name);
+    void setChannelAttribute(const std::string &channel, const std::string &name, const Pothos::Object &value);
+    std::string deviceAttributeData(const std::string &name);
+    void loadDeviceAttribute(const std::string &name, const std::string &path);
+    std::string channelAttributeData(const std::string &channel, const std::string &name);
+    void loadChannelAttribute(const std::string &channel, const std::string &name, const std::string &path);
+    std::string deviceAttributeConstraint(const std::string &name);
+    std::string channelAttributeConstraint(const std::string &channel, const std::string &name);
+
+    uint32_t regRead(const uint32_t address);
+    void regWrite(const uint32_t address, const uint32_t value);
+    std::vector<uint32_t> regReadBatch(const std::vector<uint32_t> &addresses);
+    void regWriteBatch(const std::vector<uint32_t> &addresses, const std::vector<uint32_t> &values);
+    std::vector<std::string> debugAttributeNames(void);
+    std::string debugAttribute(const std::string &name);
+    void setDebugAttribute(const std::string &name, const Pothos::Object &value);
+
+    std::string saveProfile(const std::string &path);
+    size_t loadProfile(const std::string &path);
+
+    void watchDeviceAttribute(const std::string &name);
+    void watchChannelAttribute(const std::string &channel, const std::string &name);
+    void unwatchDeviceAttribute(const std::string &name);
+    void unwatchChannelAttribute(const std::string &channel, const std::string &name);
+
+    void setBufferHook(const std::string &name, const std::string &args);
+    void setRecoveryAttempts(const size_t attempts);
+    unsigned long long recoveries(void) const;
+
+    /*!
+     * Run the calibration sweep on the block's channels, which needs the
+     * block to be inactive.
+     */
+    std::string calibrate(void);
+
+    Pothos::Object opaqueCallHandler(const std::string &name, const Pothos::Object *inputArgs, const size_t numArgs);
+
+protected:
+    const std::string className;
+    std::unique_ptr<IIODevice> dev;
+    std::unique_ptr<IIOBuffer> buf;
+    std::vector<IIOChannel> channels;
+    bool enablePorts;
+    size_t bufferSize;
+    std::shared_ptr<IIOBufferHook> hook;
+    IIOBufferLayout hookLayout;
+    IIOBufferRecovery recovery;
+
+    IIODevice &findDevice(void);
+    IIOChannel findChannel(const std::string &id);
+
+    /*!
+     * Check if any of the selected channels is a scan element.
+     */
+    bool haveScanElements(void);
+
+    /*!
+     * Enable the selected channels and, if there are scan elements and
+     * ports are enabled, create a non-blocking buffer. The buffer layout
+     * passed to the hook is updated to match.
+     */
+    void createBuffer(void);
+
+    /*!
+     * Pass count scans at the start of the buffer to the hook, if there is
+     * one.
+     */
+    void runHook(size_t count, unsigned long long sampleIndex, long long timeNs);
+
+    /*!
+     * Try to recreate the buffer once the recovery backoff has passed.
+     * Returns true once the buffer has been recreated, and throws once
+     * recovery has run out of attempts.
+     */
+    bool recoverBuffer(void);
+
+    /*!
+     * Wait for the deadline, in nanoseconds of IIOClockCorrelator::now(),
+     * for no longer than the work timeout, then yield so that work() is
+     * called again to check it. Long waits are made of bounded slices, so
+     * the worker thread neither spins nor stops responding to calls and
+     * deactivation.
+     */
+    void waitUntil(const long long deadlineNs);
+
+    /*!
+     * Emit the attribute changes queued by the watcher thread, which keeps
+     * only the latest value of each attribute.
+     */
+    void emitAttributeChanges(void);
+
+    /*!
+     * The sample rate passed to the calibration sweep, or zero if unknown.
+     */
+    virtual double calibrationSampleRate(void);
+
+private:
+    std::set<std::string> attrCalls;
+    std::set<std::string> attrProbes;
+    std::mutex attrChangesMutex;
+    std::vector<std::pair<std::string, std::string>> attrChanges;
+    std::unique_ptr<IIOAttrWatcher> watcher;
+
+    IIOAttrWatcher &attrWatcher(void);
+    void registerAttributeCall(const IIOAttrCall &call);
+    void registerAttributeProbes(void);
+    void registerAttributeCallProbe(const IIOAttrCall &call);
+};
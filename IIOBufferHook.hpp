@@ -0,0 +1,79 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <Pothos/Plugin.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IIOCodec.hpp"
+
+/*!
+ * The scans of an IIO buffer which are passed to a buffer hook.
+ */
+struct IIOBufferLayout
+{
+    //the first scan, and the number of scans and the bytes between them
+    void *start;
+    size_t count;
+    ptrdiff_t step;
+
+    //the index of the first scan in the stream, and its time in nanoseconds
+    //when known
+    unsigned long long sampleIndex;
+    long long timeNs;
+
+    //true when the scans are about to be pushed to an output device
+    bool output;
+
+    //the offset and format of each enabled scan element within a scan
+    std::vector<IIOCodecChannel> channels;
+
+    IIOBufferLayout(void) : start(nullptr), count(0), step(0), sampleIndex(0), timeNs(0), output(false) {}
+};
+
+/*!
+ * IIOBufferHook is a kernel which processes the raw scans of an IIO buffer
+ * in place: after each refill and before the IIO source demultiplexes it,
+ * or after the IIO sink has filled it and before it is pushed.
+ *
+ * Hooks are provided by plugins registered under /iio/hooks/<name>, as a
+ * Pothos::Callable which takes an arguments string and returns an
+ * std::shared_ptr<IIOBufferHook>:
+ *
+ *     pothos_static_block(registerMyHook)
+ *     {
+ *         Pothos::PluginRegistry::add("/iio/hooks/my_hook",
+ *             Pothos::Callable(&MyHook::make));
+ *     }
+ */
+class IIOBufferHook
+{
+public:
+    virtual ~IIOBufferHook(void) {}
+
+    /*!
+     * Process the scans of a buffer in place.
+     */
+    virtual void process(const IIOBufferLayout &layout) = 0;
+
+    /*!
+     * Create the hook registered under the given name.
+     */
+    static std::shared_ptr<IIOBufferHook> load(const std::string &name, const std::string &args)
+    {
+        const Pothos::PluginPath path("/iio/hooks/" + name);
+        if (!Pothos::PluginRegistry::exists(path))
+        {
+            throw Pothos::NotFoundException("IIOBufferHook::load()", "no buffer hook named " + name);
+        }
+        const auto &factory = Pothos::PluginRegistry::get(path).getObject().extract<Pothos::Callable>();
+        auto hook = factory.call<std::shared_ptr<IIOBufferHook>>(args);
+        if (!hook)
+        {
+            throw Pothos::NullPointerException("IIOBufferHook::load()", "buffer hook " + name + " was not created");
+        }
+        return hook;
+    }
+};
@@ -0,0 +1,288 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework.hpp>
+#include <poll.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "IIOCalibration.hpp"
+
+#include <json.hpp>
+using json = nlohmann::json;
+
+#ifndef RUSAGE_THREAD
+#define RUSAGE_THREAD 1
+#endif
+
+namespace
+{
+    struct CalibrationPoint
+    {
+        size_t bufferSize;
+        unsigned int bufferCount;
+        bool blocking;
+        double sampleRate;
+        double cpuNsPerSample;
+        double estimatedXrunsPerSecond;
+        size_t xruns;
+        size_t errors;
+    };
+}
+
+//the status register of the ADI AXI ADC and DAC cores, checked the same way
+//by iio_readdev and iio_writedev: the flags stick until written back
+static const uint32_t ADI_STATUS_REG = 0x80000088;
+static const uint32_t ADI_STATUS_UNDERFLOW = 1 << 0;
+static const uint32_t ADI_STATUS_OVERFLOW = 1 << 2;
+
+//the xrun flag of the device, or zero if it has none
+static uint32_t xrunFlag(IIODevice dev, bool output)
+{
+    const std::string name = dev.name();
+    if (name.compare(0, 3, "cf-") != 0 && name.compare(0, 4, "axi-") != 0)
+        return 0;
+    const uint32_t flag = output ? ADI_STATUS_UNDERFLOW : ADI_STATUS_OVERFLOW;
+    try
+    {
+        dev.regRead(ADI_STATUS_REG);
+        dev.regWrite(ADI_STATUS_REG, flag);
+    }
+    catch (const Pothos::Exception &)
+    {
+        return 0;
+    }
+    return flag;
+}
+
+//check and clear the xrun flag
+static bool takeXrun(IIODevice dev, uint32_t flag)
+{
+    try
+    {
+        if ((dev.regRead(ADI_STATUS_REG) & flag) == 0)
+            return false;
+        dev.regWrite(ADI_STATUS_REG, flag);
+        return true;
+    }
+    catch (const Pothos::Exception &)
+    {
+        return false;
+    }
+}
+
+static long long threadCpuNs(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return (static_cast<long long>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000 +
+        (static_cast<long long>(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000;
+}
+
+IIOCalibration::IIOCalibration(void)
+    : bufferSizes({1024, 4096, 16384, 65536}), bufferCounts({2, 4, 8}), burstSeconds(0.25)
+{
+}
+
+std::string IIOCalibration::run(IIODevice dev, std::vector<IIOChannel> channels, double nominalRate) const
+{
+    typedef std::chrono::steady_clock Clock;
+
+    bool output = false;
+    bool haveScanElements = false;
+    for (auto c : channels)
+    {
+        if (!c.isScanElement())
+            continue;
+        c.enable();
+        output = c.isOutput();
+        haveScanElements = true;
+    }
+    if (!haveScanElements)
+    {
+        throw Pothos::InvalidArgumentException("IIOCalibration::run()", "no scan elements to stream");
+    }
+
+    if (nominalRate <= 0.0)
+    {
+        try
+        {
+            nominalRate = std::stod(dev.attributes().at("sampling_frequency").value());
+        }
+        catch (const std::exception &)
+        {
+            for (auto c : channels)
+            {
+                try
+                {
+                    nominalRate = std::stod(c.attributes().at("sampling_frequency").value());
+                    break;
+                }
+                catch (const std::exception &) {}
+            }
+        }
+    }
+
+    const uint32_t xrunMask = xrunFlag(dev, output);
+    std::vector<CalibrationPoint> points;
+    bool kernelBuffersSupported = true;
+    for (const auto count : this->bufferCounts)
+    {
+        //backends without a kernel buffer count are only measured once per size
+        try
+        {
+            dev.setKernelBuffersCount(count);
+        }
+        catch (const Pothos::Exception &)
+        {
+            if (!points.empty()) break;
+            kernelBuffersSupported = false;
+        }
+
+        for (const auto size : this->bufferSizes)
+        {
+            for (const bool blocking : {true, false})
+            {
+                CalibrationPoint p;
+                p.bufferSize = size;
+                p.bufferCount = kernelBuffersSupported ? count : 0;
+                p.blocking = blocking;
+                p.sampleRate = 0.0;
+                p.cpuNsPerSample = 0.0;
+                p.estimatedXrunsPerSecond = 0.0;
+                p.xruns = 0;
+                p.errors = 0;
+
+                IIOBuffer buf(dev.createBuffer(size, false));
+                buf.setBlockingMode(blocking);
+                if (output)
+                {
+                    std::memset(buf.start(), 0, static_cast<char *>(buf.end()) - static_cast<char *>(buf.start()));
+                }
+                const size_t step = buf.step();
+
+                //the first transfer starts the stream and is not timed
+                auto transfer = [&](void) -> size_t
+                {
+                    if (!blocking)
+                    {
+                        struct pollfd pfd = {
+                            .fd = buf.fd(),
+                            .events = static_cast<short>(output ? POLLOUT : POLLIN),
+                            .revents = 0
+                        };
+                        if (poll(&pfd, 1, 1000) <= 0)
+                            return 0;
+                    }
+                    try
+                    {
+                        return (output ? buf.push(size) : buf.refill()) / step;
+                    }
+                    catch (const Pothos::SystemException &)
+                    {
+                        p.errors++;
+                        return 0;
+                    }
+                };
+                transfer();
+                if (xrunMask) takeXrun(dev, xrunMask);
+
+                size_t samples = 0;
+                const long long cpuStart = threadCpuNs();
+                const auto start = Clock::now();
+                auto now = start;
+                while (now - start < std::chrono::duration<double>(this->burstSeconds) && p.errors < 4)
+                {
+                    samples += transfer();
+                    if (xrunMask && takeXrun(dev, xrunMask)) p.xruns++;
+                    now = Clock::now();
+                }
+                const double elapsed = std::chrono::duration<double>(now - start).count();
+                const long long cpuNs = threadCpuNs() - cpuStart;
+
+                if (elapsed > 0.0) p.sampleRate = samples / elapsed;
+                if (samples > 0) p.cpuNsPerSample = double(cpuNs) / samples;
+                if (nominalRate > 0.0 && elapsed > 0.0)
+                {
+                    const double missing = nominalRate * elapsed - samples;
+                    p.estimatedXrunsPerSecond = std::max(0.0, missing / size / elapsed);
+                }
+                points.push_back(p);
+            }
+        }
+        if (!kernelBuffersSupported) break;
+    }
+
+    //restore the libiio default
+    try
+    {
+        if (kernelBuffersSupported) dev.setKernelBuffersCount(4);
+    }
+    catch (const Pothos::Exception &) {}
+
+    //points which kept up with the device, or with the best rate measured
+    double bestRate = 0.0;
+    for (const auto &p : points) bestRate = std::max(bestRate, p.sampleRate);
+    auto keptUp = [&](const CalibrationPoint &p)
+    {
+        if (p.errors != 0)
+            return false;
+        if (xrunMask)
+            return p.xruns == 0;
+        if (nominalRate > 0.0)
+            return p.estimatedXrunsPerSecond == 0.0 || p.sampleRate >= 0.99 * nominalRate;
+        return p.sampleRate >= 0.99 * bestRate;
+    };
+
+    const CalibrationPoint *best = nullptr;
+    for (const auto &p : points)
+    {
+        if (!keptUp(p))
+            continue;
+        const size_t latency = p.bufferSize * std::max(1u, p.bufferCount);
+        const size_t bestLatency = best ? best->bufferSize * std::max(1u, best->bufferCount) : 0;
+        if (!best || latency < bestLatency || (latency == bestLatency && p.cpuNsPerSample < best->cpuNsPerSample))
+            best = &p;
+    }
+    //nothing kept up: recommend the fastest
+    for (const auto &p : points)
+    {
+        if (best == nullptr || (!keptUp(*best) && p.sampleRate > best->sampleRate))
+            best = &p;
+    }
+
+    const char *xrunKey = output ? "underruns" : "overruns";
+    const char *estimateKey = output ? "estimatedUnderrunsPerSecond" : "estimatedOverrunsPerSecond";
+    auto toJSON = [&](const CalibrationPoint &p)
+    {
+        json obj;
+        obj["bufferSize"] = p.bufferSize;
+        obj["bufferCount"] = p.bufferCount;
+        obj["waitStrategy"] = p.blocking ? "blocking" : "poll";
+        obj["sampleRate"] = p.sampleRate;
+        obj["cpuNsPerSample"] = p.cpuNsPerSample;
+        if (xrunMask) obj[xrunKey] = p.xruns;
+        obj[estimateKey] = p.estimatedXrunsPerSecond;
+        obj["errors"] = p.errors;
+        return obj;
+    };
+
+    json result;
+    result["device"] = dev.id();
+    result["direction"] = output ? "output" : "input";
+    result["nominalSampleRate"] = nominalRate;
+    result["kernelBufferCountSupported"] = kernelBuffersSupported;
+    result["xrunsMeasured"] = xrunMask != 0;
+    auto &pointArray = result["points"];
+    pointArray = json::array();
+    for (const auto &p : points) pointArray.push_back(toJSON(p));
+    if (best)
+    {
+        result["recommended"] = toJSON(*best);
+        result["recommended"]["keptUp"] = keptUp(*best);
+    }
+    return result.dump();
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <string>
+#include <vector>
+#include "IIOSupport.hpp"
+
+/*!
+ * IIOCalibration measures the streaming throughput of a device across a
+ * grid of buffer sizes, kernel buffer counts and wait strategies, and
+ * recommends a configuration.
+ *
+ * Each point of the grid runs a short burst of refills (for input devices)
+ * or pushes (for output devices) and records:
+ *
+ *  - the sustained sample rate,
+ *  - the CPU time spent per sample by the calling thread,
+ *  - the overruns or underruns per second, estimated from the shortfall
+ *    between the achieved and nominal sample rates when the nominal rate is
+ *    known,
+ *  - the number of overruns or underruns flagged by the device, for the
+ *    ADI AXI cores ("cf-*" and "axi-*" devices) whose status register can
+ *    be read through debugfs, and
+ *  - the number of failed buffer operations.
+ *
+ * Where the device flags xruns, a configuration keeps up when none were
+ * flagged; otherwise the estimate is used.
+ *
+ * The recommended configuration is the one with the least buffering
+ * latency among those which kept up with the nominal rate (or, if it is
+ * unknown, came within 1% of the best rate measured), with CPU per sample
+ * breaking ties.
+ */
+class IIOCalibration
+{
+public:
+    std::vector<size_t> bufferSizes;
+    std::vector<unsigned int> bufferCounts;
+    double burstSeconds;
+
+    IIOCalibration(void);
+
+    /*!
+     * Run the sweep on the given scan element channels, which are enabled,
+     * and return the measurements and recommendation as JSON. The device
+     * must not have a buffer open. If the nominal rate is zero, it is read
+     * from the "sampling_frequency" attribute of the device or a channel.
+     */
+    std::string run(IIODevice dev, std::vector<IIOChannel> channels, double nominalRate) const;
+};
@@ -0,0 +1,222 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "IIOSupport.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+/*!
+ * IIOChannelView is a random-access range over the samples of one channel,
+ * in place within an IIOBuffer, so that they can be inspected or modified
+ * without copying them out through IIOChannel::read().
+ *
+ * T is the storage type of a sample, and must be as large as the channel's
+ * sample length. Elements are accessed through a proxy which converts them
+ * to and from host byte order, but does not shift or sign extend them; use
+ * IIOSampleConverter for normalized values.
+ */
+template <class T>
+class IIOChannelView
+{
+public:
+    /*!
+     * A reference to one sample in the buffer. Samples may be unaligned.
+     */
+    class Reference
+    {
+        friend class IIOChannelView<T>;
+    private:
+        char *p;
+        bool swap;
+        Reference(char *p, bool swap) : p(p), swap(swap) {}
+    public:
+        operator T(void) const
+        {
+            T v;
+            std::memcpy(&v, this->p, sizeof(v));
+            return this->swap ? byteSwap(v) : v;
+        }
+        Reference &operator=(T v)
+        {
+            if (this->swap) v = byteSwap(v);
+            std::memcpy(this->p, &v, sizeof(v));
+            return *this;
+        }
+        Reference &operator=(const Reference &other)
+        {
+            return *this = T(other);
+        }
+        friend void swap(Reference a, Reference b)
+        {
+            const T v = a;
+            a = T(b);
+            b = v;
+        }
+    };
+
+    class Iterator
+    {
+        friend class IIOChannelView<T>;
+    private:
+        char *p;
+        ptrdiff_t step;
+        bool swap;
+        Iterator(char *p, ptrdiff_t step, bool swap) : p(p), step(step), swap(swap) {}
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = void;
+        using reference = Reference;
+        using iterator_category = std::random_access_iterator_tag;
+
+        Iterator(void) : p(nullptr), step(0), swap(false) {}
+
+        Reference operator*() const { return Reference(this->p, this->swap); }
+        Reference operator[](ptrdiff_t n) const { return Reference(this->p + n * this->step, this->swap); }
+
+        Iterator& operator++() { this->p += this->step; return *this; }
+        Iterator& operator--() { this->p -= this->step; return *this; }
+        Iterator operator++(int) { Iterator retval = *this; ++(*this); return retval; }
+        Iterator operator--(int) { Iterator retval = *this; --(*this); return retval; }
+        Iterator& operator+=(ptrdiff_t n) { this->p += n * this->step; return *this; }
+        Iterator& operator-=(ptrdiff_t n) { this->p -= n * this->step; return *this; }
+        Iterator operator+(ptrdiff_t n) const { Iterator retval = *this; return retval += n; }
+        Iterator operator-(ptrdiff_t n) const { Iterator retval = *this; return retval -= n; }
+        friend Iterator operator+(ptrdiff_t n, const Iterator &it) { return it + n; }
+        ptrdiff_t operator-(const Iterator &other) const { return (this->p - other.p) / this->step; }
+
+        bool operator==(const Iterator &other) const { return this->p == other.p; }
+        bool operator!=(const Iterator &other) const { return this->p != other.p; }
+        bool operator<(const Iterator &other) const { return this->p < other.p; }
+        bool operator>(const Iterator &other) const { return this->p > other.p; }
+        bool operator<=(const Iterator &other) const { return this->p <= other.p; }
+        bool operator>=(const Iterator &other) const { return this->p >= other.p; }
+    };
+
+    /*!
+     * View the samples of a channel in a buffer, from iio_buffer_first() up
+     * to the end of the buffer.
+     */
+    IIOChannelView(IIOBuffer &buffer, IIOChannel channel)
+    {
+        const struct iio_data_format &format = channel.format();
+        if (format.length / 8 != sizeof(T) || format.repeat > 1)
+        {
+            throw Pothos::DataFormatException("IIOChannelView::IIOChannelView()", "storage type does not match channel " + channel.id());
+        }
+        this->first = static_cast<char *>(buffer.first(channel));
+        this->step = buffer.step();
+        const ptrdiff_t bytes = static_cast<char *>(buffer.end()) - this->first;
+        this->count = (bytes > 0) ? (bytes + this->step - 1) / this->step : 0;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        this->swap = !format.is_be && sizeof(T) > 1;
+#else
+        this->swap = format.is_be && sizeof(T) > 1;
+#endif
+    }
+
+    /*!
+     * View count samples spaced step bytes apart, starting at first.
+     */
+    IIOChannelView(void *first, ptrdiff_t step, size_t count, bool swap = false)
+        : first(static_cast<char *>(first)), step(step), count(count), swap(swap) {}
+
+    size_t size(void) const { return this->count; }
+    bool empty(void) const { return this->count == 0; }
+    ptrdiff_t stride(void) const { return this->step; }
+
+    Iterator begin(void) const { return Iterator(this->first, this->step, this->swap); }
+    Iterator end(void) const { return Iterator(this->first + this->count * this->step, this->step, this->swap); }
+    Reference operator[](size_t n) const { return Reference(this->first + n * this->step, this->swap); }
+
+    /*!
+     * Copy count samples, starting at offset, into contiguous memory.
+     */
+    void gather(T *dst, size_t offset, size_t count) const
+    {
+        const char *p = this->first + offset * this->step;
+        if (!this->swap && this->step == ptrdiff_t(sizeof(T)))
+        {
+            std::memcpy(dst, p, count * sizeof(T));
+            return;
+        }
+
+        //unrolled so that the loads of a batch are independent
+        size_t n = 0;
+        for (; n + 4 <= count; n += 4, p += 4 * this->step)
+        {
+            T v0, v1, v2, v3;
+            std::memcpy(&v0, p, sizeof(T));
+            std::memcpy(&v1, p + this->step, sizeof(T));
+            std::memcpy(&v2, p + 2 * this->step, sizeof(T));
+            std::memcpy(&v3, p + 3 * this->step, sizeof(T));
+            if (this->swap)
+            {
+                v0 = byteSwap(v0); v1 = byteSwap(v1);
+                v2 = byteSwap(v2); v3 = byteSwap(v3);
+            }
+            dst[n] = v0; dst[n + 1] = v1; dst[n + 2] = v2; dst[n + 3] = v3;
+        }
+        for (; n < count; n++, p += this->step)
+        {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            dst[n] = this->swap ? byteSwap(v) : v;
+        }
+    }
+
+    /*!
+     * Copy count samples from contiguous memory into the view, starting at
+     * offset.
+     */
+    void scatter(const T *src, size_t offset, size_t count) const
+    {
+        char *p = this->first + offset * this->step;
+        if (!this->swap && this->step == ptrdiff_t(sizeof(T)))
+        {
+            std::memcpy(p, src, count * sizeof(T));
+            return;
+        }
+
+        size_t n = 0;
+        for (; n + 4 <= count; n += 4, p += 4 * this->step)
+        {
+            T v0 = src[n], v1 = src[n + 1], v2 = src[n + 2], v3 = src[n + 3];
+            if (this->swap)
+            {
+                v0 = byteSwap(v0); v1 = byteSwap(v1);
+                v2 = byteSwap(v2); v3 = byteSwap(v3);
+            }
+            std::memcpy(p, &v0, sizeof(T));
+            std::memcpy(p + this->step, &v1, sizeof(T));
+            std::memcpy(p + 2 * this->step, &v2, sizeof(T));
+            std::memcpy(p + 3 * this->step, &v3, sizeof(T));
+        }
+        for (; n < count; n++, p += this->step)
+        {
+            T v = this->swap ? byteSwap(src[n]) : src[n];
+            std::memcpy(p, &v, sizeof(T));
+        }
+    }
+
+private:
+    char *first;
+    ptrdiff_t step;
+    size_t count;
+    bool swap;
+
+    static T byteSwap(T v)
+    {
+        switch (sizeof(T))
+        {
+            case 2: { uint16_t w; std::memcpy(&w, &v, 2); w = __builtin_bswap16(w); std::memcpy(&v, &w, 2); break; }
+            case 4: { uint32_t w; std::memcpy(&w, &v, 4); w = __builtin_bswap32(w); std::memcpy(&v, &w, 4); break; }
+            case 8: { uint64_t w; std::memcpy(&w, &v, 8); w = __builtin_bswap64(w); std::memcpy(&v, &w, 8); break; }
+            default: break;
+        }
+        return v;
+    }
+};
@@ -0,0 +1,166 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "IIOFFT.hpp"
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+/*!
+ * IIOChannelizer is a critically sampled polyphase analysis filterbank which
+ * splits a complex stream into M sub-bands, each decimated by M.
+ *
+ * Sub-band k is centred on k/M of the input sample rate; sub-bands above
+ * M/2 correspond to negative frequencies.
+ */
+class IIOChannelizer
+{
+private:
+    size_t m;
+    size_t tapsPerBranch;
+    IIOFFT fft;
+
+    //taps regrouped so that each polyphase step is a contiguous dot product
+    std::vector<float> branchTaps;
+
+    //input samples not yet fully consumed, preceded by the filter history
+    std::vector<std::complex<float>> history;
+    size_t next;
+
+    std::vector<std::complex<float>> accum;
+
+public:
+    IIOChannelizer(void) : m(1), tapsPerBranch(1), next(0) {}
+
+    /*!
+     * Create a channelizer with numSubbands sub-bands using the given
+     * prototype lowpass filter. If no taps are given, a windowed-sinc
+     * prototype with 8 taps per branch is designed.
+     */
+    IIOChannelizer(size_t numSubbands, std::vector<float> taps = std::vector<float>()) :
+        m(numSubbands), fft(numSubbands)
+    {
+        if (taps.empty())
+        {
+            taps = designPrototype(numSubbands, 8);
+        }
+        if (taps.size() % numSubbands != 0)
+        {
+            taps.resize((taps.size() / numSubbands + 1) * numSubbands, 0.0f);
+        }
+        this->tapsPerBranch = taps.size() / numSubbands;
+
+        //branchTaps[l*M + q] multiplies history[base + q] for polyphase step l
+        this->branchTaps.resize(taps.size());
+        for (size_t l = 0; l < this->tapsPerBranch; l++)
+        {
+            for (size_t q = 0; q < this->m; q++)
+            {
+                this->branchTaps[l * this->m + q] = taps[l * this->m + (this->m - 1 - q)];
+            }
+        }
+
+        this->accum.resize(this->m);
+        this->reset();
+    }
+
+    /*!
+     * Design a windowed-sinc prototype lowpass for numSubbands sub-bands with
+     * tapsPerBranch taps per polyphase branch and unity DC gain.
+     */
+    static std::vector<float> designPrototype(size_t numSubbands, size_t tapsPerBranch)
+    {
+        const double pi = std::acos(-1.0);
+        const size_t len = numSubbands * tapsPerBranch;
+        const double centre = (len - 1) / 2.0;
+        std::vector<float> taps(len);
+        double sum = 0.0;
+        for (size_t i = 0; i < len; i++)
+        {
+            const double t = (i - centre) / numSubbands;
+            const double sinc = (t == 0.0) ? 1.0 : std::sin(pi * t) / (pi * t);
+            const double x = 2.0 * pi * i / (len - 1);
+            const double window = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+            taps[i] = static_cast<float>(sinc * window);
+            sum += taps[i];
+        }
+        for (auto &t : taps) t = static_cast<float>(t / sum);
+        return taps;
+    }
+
+    /*!
+     * Get the number of sub-bands.
+     */
+    size_t numSubbands(void) const
+    {
+        return this->m;
+    }
+
+    /*!
+     * Clear the filter history.
+     */
+    void reset(void)
+    {
+        this->history.assign(this->branchTaps.size() - 1, std::complex<float>());
+        this->next = this->history.size();
+    }
+
+    /*!
+     * Get the maximum number of output samples per sub-band produced by the
+     * next call to process() with count input samples.
+     */
+    size_t maxOutputs(size_t count) const
+    {
+        return (this->history.size() + count - this->next + this->m - 1) / this->m;
+    }
+
+    /*!
+     * Channelize count input samples. For each output sample, the selected
+     * sub-bands are written to outputs[i][n], where subbands[i] selects the
+     * sub-band. Returns the number of samples written per sub-band.
+     */
+    size_t process(const std::complex<float> *input, size_t count,
+        const std::vector<size_t> &subbands, std::complex<float> * const *outputs)
+    {
+        this->history.insert(this->history.end(), input, input + count);
+
+        const size_t len = this->branchTaps.size();
+        size_t produced = 0;
+        while (this->next < this->history.size())
+        {
+            //accumulate the polyphase branches, newest sample at this->next
+            std::fill(this->accum.begin(), this->accum.end(), std::complex<float>());
+            for (size_t l = 0; l < this->tapsPerBranch; l++)
+            {
+                const std::complex<float> *x = &this->history[this->next - l * this->m - (this->m - 1)];
+                const float *h = &this->branchTaps[l * this->m];
+                std::complex<float> *acc = this->accum.data();
+                for (size_t q = 0; q < this->m; q++)
+                {
+                    acc[q] += h[q] * x[q];
+                }
+            }
+
+            //accum[q] holds branch M-1-q; the inverse DFT over branches
+            //mixes each sub-band down to baseband
+            std::reverse(this->accum.begin(), this->accum.end());
+            this->fft.transform(this->accum.data(), true);
+
+            for (size_t i = 0; i < subbands.size(); i++)
+            {
+                outputs[i][produced] = this->accum[subbands[i]];
+            }
+            produced++;
+            this->next += this->m;
+        }
+
+        //keep only the history needed for the next output
+        const size_t consumed = this->next - (len - 1);
+        this->history.erase(this->history.begin(), this->history.begin() + consumed);
+        this->next -= consumed;
+
+        return produced;
+    }
+};
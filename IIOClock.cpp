@@ -0,0 +1,141 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "IIOClock.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <time.h>
+
+IIOClockCorrelator::IIOClockCorrelator(size_t window)
+    : window(std::max<size_t>(window, 4))
+{
+    this->reset();
+}
+
+long long IIOClockCorrelator::now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void IIOClockCorrelator::reset(void)
+{
+    this->hwBaseNs = 0;
+    this->hostBaseNs = 0;
+    this->haveBase = false;
+    this->observations.clear();
+    this->offset = 0.0;
+    this->slope = 1.0;
+    this->rate = 0.0;
+}
+
+void IIOClockCorrelator::fitLine(const std::deque<Observation> &obs,
+    double Observation::*x, double Observation::*y,
+    bool rejectOutliers, double &intercept, double &slope)
+{
+    std::vector<bool> used(obs.size(), true);
+
+    for (int pass = 0; pass < (rejectOutliers ? 2 : 1); pass++)
+    {
+        //least squares fit over the points still in use
+        double n = 0, sx = 0, sy = 0;
+        for (size_t i = 0; i < obs.size(); i++)
+        {
+            if (!used[i]) continue;
+            n += 1;
+            sx += obs[i].*x;
+            sy += obs[i].*y;
+        }
+        const double mx = sx / n, my = sy / n;
+        double sxx = 0, sxy = 0;
+        for (size_t i = 0; i < obs.size(); i++)
+        {
+            if (!used[i]) continue;
+            sxx += (obs[i].*x - mx) * (obs[i].*x - mx);
+            sxy += (obs[i].*x - mx) * (obs[i].*y - my);
+        }
+        if (sxx > 0) slope = sxy / sxx;
+        intercept = my - slope * mx;
+
+        if (pass == 1 || !rejectOutliers)
+            break;
+
+        //host readings are only ever late, so reject points well above the
+        //median residual using the median absolute deviation as the scale
+        std::vector<double> residuals;
+        for (const auto &o : obs)
+        {
+            residuals.push_back(o.*y - (intercept + slope * o.*x));
+        }
+        std::vector<double> sorted(residuals);
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        const double median = sorted[sorted.size() / 2];
+        for (auto &r : sorted) r = std::abs(r - median);
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        const double mad = sorted[sorted.size() / 2];
+        for (size_t i = 0; i < obs.size(); i++)
+        {
+            used[i] = residuals[i] <= median + 3.0 * 1.4826 * mad;
+        }
+    }
+}
+
+void IIOClockCorrelator::update(long long hwTimeNs, unsigned long long sampleCount, long long hostBeforeNs, long long hostAfterNs)
+{
+    //times are kept relative to the first observation so that doubles
+    //retain sub-nanosecond resolution
+    if (!this->haveBase)
+    {
+        this->hwBaseNs = hwTimeNs;
+        this->hostBaseNs = hostBeforeNs;
+        this->haveBase = true;
+    }
+
+    //the refill completed somewhere between the two host readings
+    Observation obs;
+    obs.hwTime = (hwTimeNs - this->hwBaseNs) / 1e9;
+    obs.hostTime = ((hostBeforeNs - this->hostBaseNs) + (hostAfterNs - this->hostBaseNs)) / 2e9;
+    obs.samples = static_cast<double>(sampleCount);
+    this->observations.push_back(obs);
+    while (this->observations.size() > this->window)
+    {
+        this->observations.pop_front();
+    }
+
+    if (this->observations.size() < 2)
+    {
+        this->offset = obs.hostTime - obs.hwTime;
+        this->slope = 1.0;
+        return;
+    }
+
+    this->fitLine(this->observations, &Observation::hwTime, &Observation::hostTime, true, this->offset, this->slope);
+    //fit host time against sample count too, so that late host readings
+    //remain vertical outliers, then invert for samples per host second
+    double hostOffset = 0.0, secondsPerSample = 0.0;
+    this->fitLine(this->observations, &Observation::samples, &Observation::hostTime, true, hostOffset, secondsPerSample);
+    this->rate = (secondsPerSample > 0.0) ? 1.0 / secondsPerSample : 0.0;
+}
+
+bool IIOClockCorrelator::locked(void) const
+{
+    return this->observations.size() >= 4;
+}
+
+long long IIOClockCorrelator::toHostNs(long long hwTimeNs) const
+{
+    const double hwTime = (hwTimeNs - this->hwBaseNs) / 1e9;
+    return this->hostBaseNs + std::llround((this->offset + this->slope * hwTime) * 1e9);
+}
+
+double IIOClockCorrelator::driftPpm(void) const
+{
+    return (this->slope - 1.0) * 1e6;
+}
+
+double IIOClockCorrelator::measuredSampleRate(void) const
+{
+    return this->rate;
+}
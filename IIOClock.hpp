@@ -0,0 +1,89 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <cstddef>
+#include <deque>
+
+/*!
+ * IIOClockCorrelator relates a device's hardware time to the host's
+ * CLOCK_REALTIME, estimating both the offset between the two clocks and the
+ * drift of the hardware clock relative to the host.
+ *
+ * Each call to update() pairs a hardware time with host clock readings taken
+ * immediately before and after the iio_buffer_refill() which delivered it.
+ * A line is fitted over a sliding window of these observations; observations
+ * delayed by scheduling are rejected as outliers before the final fit, so the
+ * estimate tracks the lower envelope of the host readings.
+ */
+class IIOClockCorrelator
+{
+private:
+    struct Observation
+    {
+        double hwTime;
+        double hostTime;
+        double samples;
+    };
+
+    size_t window;
+    long long hwBaseNs;
+    long long hostBaseNs;
+    bool haveBase;
+    std::deque<Observation> observations;
+
+    //host = offset + slope * hwTime, in seconds relative to the base times
+    double offset;
+    double slope;
+
+    //measured samples per host second
+    double rate;
+
+    static void fitLine(const std::deque<Observation> &obs,
+        double Observation::*x, double Observation::*y,
+        bool rejectOutliers, double &intercept, double &slope);
+
+public:
+    IIOClockCorrelator(size_t window = 64);
+
+    /*!
+     * Get the current host time, in nanoseconds since the epoch.
+     */
+    static long long now(void);
+
+    /*!
+     * Discard all observations.
+     */
+    void reset(void);
+
+    /*!
+     * Add an observation. hwTimeNs is the hardware time of the last sample in
+     * the refill, in nanoseconds. sampleCount is the total number of samples
+     * received up to and including the refill. hostBeforeNs and hostAfterNs
+     * are host times taken around the refill.
+     */
+    void update(long long hwTimeNs, unsigned long long sampleCount, long long hostBeforeNs, long long hostAfterNs);
+
+    /*!
+     * Check if enough observations have been made for the estimates to be
+     * meaningful.
+     */
+    bool locked(void) const;
+
+    /*!
+     * Convert a hardware time in nanoseconds to host time in nanoseconds
+     * since the epoch.
+     */
+    long long toHostNs(long long hwTimeNs) const;
+
+    /*!
+     * Get the drift of the hardware clock relative to the host clock, in
+     * parts per million. Positive values mean the hardware clock is slow.
+     */
+    double driftPpm(void) const;
+
+    /*!
+     * Get the measured sample rate in samples per host second.
+     */
+    double measuredSampleRate(void) const;
+};
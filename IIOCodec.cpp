@@ -0,0 +1,504 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "IIOCodec.hpp"
+#include <Pothos/Framework.hpp>
+#include <algorithm>
+#include <cstring>
+
+static const char FILE_MAGIC[8] = {'I', 'I', 'O', 'R', 'E', 'C', '\0', '\1'};
+static const uint32_t BLOCK_MAGIC = 0x4b4c4249; //"IBLK"
+static const uint32_t INDEX_MAGIC = 0x58444e49; //"INDX"
+static const uint32_t TRAILER_MAGIC = 0x444e4549; //"IEND"
+static const uint32_t BLOCK_FLAG_PACKED = 1 << 0;
+static const size_t BLOCK_HEADER_SIZE = 32;
+static const size_t TRAILER_SIZE = 12;
+
+/***********************************************************************
+ * Little-endian field helpers
+ **********************************************************************/
+static void put(std::vector<uint8_t> &out, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static uint64_t get(const uint8_t *in, size_t bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+static void putDouble(std::vector<uint8_t> &out, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(out, bits, 8);
+}
+
+static double getDouble(const uint8_t *in)
+{
+    const uint64_t bits = get(in, 8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/***********************************************************************
+ * Sample access in storage byte order
+ **********************************************************************/
+static uint64_t loadSample(const uint8_t *p, size_t size, bool bigEndian)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= static_cast<uint64_t>(p[bigEndian ? size - 1 - i : i]) << (8 * i);
+    }
+    return value;
+}
+
+static void storeSample(uint8_t *p, size_t size, bool bigEndian, uint64_t value)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        p[bigEndian ? size - 1 - i : i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+/***********************************************************************
+ * Bit packing of zigzag coded deltas
+ **********************************************************************/
+static unsigned bitWidth(uint64_t value)
+{
+    return value ? 64 - __builtin_clzll(value) : 0;
+}
+
+static void packGroup(const uint64_t *values, size_t n, unsigned width, std::vector<uint8_t> &out)
+{
+    uint64_t acc = 0;
+    unsigned nbits = 0;
+    for (size_t i = 0; i < n && width > 0; i++)
+    {
+        uint64_t x = values[i];
+        unsigned remaining = width;
+        while (remaining > 0)
+        {
+            //fewer than 8 bits are buffered here, so 56 more always fit
+            const unsigned take = std::min(remaining, 56u);
+            acc |= (x & ((uint64_t(1) << take) - 1)) << nbits;
+            nbits += take;
+            x >>= take;
+            remaining -= take;
+            while (nbits >= 8)
+            {
+                out.push_back(static_cast<uint8_t>(acc));
+                acc >>= 8;
+                nbits -= 8;
+            }
+        }
+    }
+    if (nbits > 0) out.push_back(static_cast<uint8_t>(acc));
+}
+
+static const uint8_t *unpackGroup(const uint8_t *in, const uint8_t *end, uint64_t *values, size_t n, unsigned width)
+{
+    uint64_t acc = 0;
+    unsigned nbits = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t x = 0;
+        unsigned have = 0;
+        while (have < width)
+        {
+            if (nbits == 0)
+            {
+                if (in == end)
+                {
+                    throw Pothos::DataFormatException("IIOBlockCodec::decode()", "truncated block");
+                }
+                acc = *in++;
+                nbits = 8;
+            }
+            const unsigned take = std::min(width - have, nbits);
+            x |= (acc & ((uint64_t(1) << take) - 1)) << have;
+            acc >>= take;
+            nbits -= take;
+            have += take;
+        }
+        values[i] = x;
+    }
+    return in;
+}
+
+/***********************************************************************
+ * IIOBlockCodec
+ **********************************************************************/
+const size_t IIOBlockCodec::GROUP_SIZE;
+
+IIOBlockCodec::IIOBlockCodec(void)
+    : step(0)
+{
+}
+
+IIOBlockCodec::IIOBlockCodec(const std::vector<IIOCodecChannel> &channels, size_t step)
+    : channels(channels), step(step)
+{
+    for (const auto &c : this->channels)
+    {
+        if (c.length == 0 || c.length > 64 || c.length % 8 != 0 || c.offset + c.length / 8 > step)
+        {
+            throw Pothos::InvalidArgumentException("IIOBlockCodec::IIOBlockCodec()", "unsupported layout for channel " + c.id);
+        }
+    }
+}
+
+bool IIOBlockCodec::encode(const void *scans, size_t count, std::vector<uint8_t> &out)
+{
+    const uint8_t *base = static_cast<const uint8_t *>(scans);
+    size_t rawSize = 0;
+    out.clear();
+    this->scratch.resize(count);
+
+    for (const auto &c : this->channels)
+    {
+        const size_t size = c.length / 8;
+        const unsigned signBits = 64 - c.length;
+        rawSize += size * count;
+
+        //zigzag coded deltas, sign extended from the storage width
+        const uint8_t *p = base + c.offset;
+        uint64_t prev = 0;
+        for (size_t n = 0; n < count; n++, p += this->step)
+        {
+            const uint64_t value = loadSample(p, size, c.isBigEndian);
+            const int64_t delta = static_cast<int64_t>((value - prev) << signBits) >> signBits;
+            this->scratch[n] = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+            prev = value;
+        }
+
+        for (size_t g = 0; g < count; g += GROUP_SIZE)
+        {
+            const size_t n = std::min(GROUP_SIZE, count - g);
+            uint64_t any = 0;
+            for (size_t i = 0; i < n; i++) any |= this->scratch[g + i];
+            const unsigned width = bitWidth(any);
+            out.push_back(static_cast<uint8_t>(width));
+            packGroup(&this->scratch[g], n, width, out);
+        }
+
+        //give up on packing once it stops paying off
+        if (out.size() >= rawSize + size * count * (this->channels.size() - 1))
+            break;
+    }
+
+    if (out.size() < rawSize)
+        return true;
+    out.clear();
+    return false;
+}
+
+void IIOBlockCodec::decode(const uint8_t *in, size_t length, size_t count, void *scans)
+{
+    uint8_t *base = static_cast<uint8_t *>(scans);
+    const uint8_t *end = in + length;
+    std::memset(base, 0, count * this->step);
+    this->scratch.resize(count);
+
+    for (const auto &c : this->channels)
+    {
+        const size_t size = c.length / 8;
+        uint8_t *p = base + c.offset;
+
+        for (size_t g = 0; g < count; g += GROUP_SIZE)
+        {
+            const size_t n = std::min(GROUP_SIZE, count - g);
+            if (in == end)
+            {
+                throw Pothos::DataFormatException("IIOBlockCodec::decode()", "truncated block");
+            }
+            const unsigned width = *in++;
+            if (width > 64)
+            {
+                throw Pothos::DataFormatException("IIOBlockCodec::decode()", "bad group width");
+            }
+            in = unpackGroup(in, end, &this->scratch[g], n, width);
+        }
+
+        uint64_t prev = 0;
+        for (size_t n = 0; n < count; n++, p += this->step)
+        {
+            const uint64_t z = this->scratch[n];
+            const uint64_t delta = (z >> 1) ^ (~(z & 1) + 1);
+            prev += delta;
+            storeSample(p, size, c.isBigEndian, prev);
+        }
+    }
+}
+
+/***********************************************************************
+ * IIORecordWriter
+ **********************************************************************/
+IIORecordWriter::IIORecordWriter(const std::string &path, const std::vector<IIOCodecChannel> &channels,
+    size_t step, double sampleRate, bool compress)
+    : codec(channels, step), step(step), compress(compress)
+{
+    this->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!this->file)
+    {
+        throw Pothos::FileException("IIORecordWriter::IIORecordWriter()", "cannot open " + path);
+    }
+
+    std::vector<uint8_t> header(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+    put(header, step, 4);
+    put(header, channels.size(), 4);
+    putDouble(header, sampleRate);
+    for (const auto &c : channels)
+    {
+        put(header, std::min<size_t>(c.id.size(), 255), 1);
+        header.insert(header.end(), c.id.begin(), c.id.begin() + std::min<size_t>(c.id.size(), 255));
+        put(header, c.offset, 4);
+        put(header, c.length, 1);
+        put(header, c.bits, 1);
+        put(header, c.shift, 1);
+        put(header, (c.isSigned ? 1 : 0) | (c.isBigEndian ? 2 : 0), 1);
+    }
+    this->file.write(reinterpret_cast<const char *>(header.data()), header.size());
+}
+
+IIORecordWriter::~IIORecordWriter(void)
+{
+    try
+    {
+        this->close();
+    }
+    catch (...) {}
+}
+
+void IIORecordWriter::write(const void *scans, size_t count, uint64_t sampleIndex, int64_t timestamp)
+{
+    if (!this->file.is_open() || count == 0)
+        return;
+
+    //blocks which do not pack are written as whole scans straight from the buffer
+    const bool packed = this->compress && this->codec.encode(scans, count, this->encoded);
+    const size_t length = packed ? this->encoded.size() : count * this->step;
+
+    IIORecordBlock block;
+    block.fileOffset = static_cast<uint64_t>(this->file.tellp());
+    block.sampleIndex = sampleIndex;
+    block.timestamp = timestamp;
+    this->index.push_back(block);
+
+    std::vector<uint8_t> header;
+    header.reserve(BLOCK_HEADER_SIZE);
+    put(header, BLOCK_MAGIC, 4);
+    put(header, packed ? BLOCK_FLAG_PACKED : 0, 4);
+    put(header, sampleIndex, 8);
+    put(header, static_cast<uint64_t>(timestamp), 8);
+    put(header, count, 4);
+    put(header, length, 4);
+    this->file.write(reinterpret_cast<const char *>(header.data()), header.size());
+    this->file.write(packed ? reinterpret_cast<const char *>(this->encoded.data()) : static_cast<const char *>(scans), length);
+
+    if (!this->file)
+    {
+        throw Pothos::WriteFileException("IIORecordWriter::write()", "write failed");
+    }
+}
+
+void IIORecordWriter::close(void)
+{
+    if (!this->file.is_open())
+        return;
+
+    std::vector<uint8_t> out;
+    const uint64_t indexOffset = static_cast<uint64_t>(this->file.tellp());
+    put(out, INDEX_MAGIC, 4);
+    put(out, this->index.size(), 8);
+    for (const auto &b : this->index)
+    {
+        put(out, b.fileOffset, 8);
+        put(out, b.sampleIndex, 8);
+        put(out, static_cast<uint64_t>(b.timestamp), 8);
+    }
+    put(out, indexOffset, 8);
+    put(out, TRAILER_MAGIC, 4);
+    this->file.write(reinterpret_cast<const char *>(out.data()), out.size());
+    this->file.close();
+    this->index.clear();
+}
+
+/***********************************************************************
+ * IIORecordReader
+ **********************************************************************/
+IIORecordReader::IIORecordReader(const std::string &path)
+    : stepSize(0), rate(0.0)
+{
+    this->file.open(path, std::ios::binary);
+    if (!this->file)
+    {
+        throw Pothos::FileNotFoundException("IIORecordReader::IIORecordReader()", "cannot open " + path);
+    }
+
+    auto readBytes = [this](size_t n)
+    {
+        std::vector<uint8_t> buf(n);
+        if (!this->file.read(reinterpret_cast<char *>(buf.data()), n))
+        {
+            throw Pothos::DataFormatException("IIORecordReader::IIORecordReader()", "truncated header");
+        }
+        return buf;
+    };
+
+    auto fixed = readBytes(sizeof(FILE_MAGIC) + 16);
+    if (!std::equal(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC), fixed.begin()))
+    {
+        throw Pothos::DataFormatException("IIORecordReader::IIORecordReader()", "not an IIO recording");
+    }
+    this->stepSize = get(&fixed[8], 4);
+    const size_t numChannels = get(&fixed[12], 4);
+    this->rate = getDouble(&fixed[16]);
+    for (size_t i = 0; i < numChannels; i++)
+    {
+        IIOCodecChannel c;
+        const auto idLength = readBytes(1)[0];
+        const auto id = readBytes(idLength);
+        c.id.assign(id.begin(), id.end());
+        const auto fields = readBytes(8);
+        c.offset = get(&fields[0], 4);
+        c.length = fields[4];
+        c.bits = fields[5];
+        c.shift = fields[6];
+        c.isSigned = (fields[7] & 1) != 0;
+        c.isBigEndian = (fields[7] & 2) != 0;
+        this->channelList.push_back(c);
+    }
+    this->codec = IIOBlockCodec(this->channelList, this->stepSize);
+    const uint64_t firstBlock = static_cast<uint64_t>(this->file.tellg());
+
+    //load the index from the trailer, if the recording was closed cleanly
+    this->file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(this->file.tellg());
+    if (fileSize >= firstBlock + TRAILER_SIZE)
+    {
+        uint8_t trailer[TRAILER_SIZE];
+        this->file.seekg(fileSize - TRAILER_SIZE);
+        this->file.read(reinterpret_cast<char *>(trailer), TRAILER_SIZE);
+        const uint64_t indexOffset = get(trailer, 8);
+        if (this->file && get(trailer + 8, 4) == TRAILER_MAGIC && indexOffset >= firstBlock && indexOffset + 12 <= fileSize)
+        {
+            this->file.seekg(indexOffset);
+            auto head = readBytes(12);
+            const uint64_t count = get(&head[4], 8);
+            if (get(&head[0], 4) == INDEX_MAGIC && indexOffset + 12 + count * 24 + TRAILER_SIZE == fileSize)
+            {
+                auto entries = readBytes(count * 24);
+                for (size_t i = 0; i < count; i++)
+                {
+                    IIORecordBlock b;
+                    b.fileOffset = get(&entries[i * 24], 8);
+                    b.sampleIndex = get(&entries[i * 24 + 8], 8);
+                    b.timestamp = static_cast<int64_t>(get(&entries[i * 24 + 16], 8));
+                    this->index.push_back(b);
+                }
+                return;
+            }
+        }
+    }
+
+    this->file.clear();
+    this->scanBlocks(firstBlock);
+}
+
+void IIORecordReader::scanBlocks(uint64_t offset)
+{
+    this->file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(this->file.tellg());
+
+    //stop at the first incomplete block
+    uint8_t header[BLOCK_HEADER_SIZE];
+    while (true)
+    {
+        this->file.seekg(offset);
+        if (!this->file.read(reinterpret_cast<char *>(header), BLOCK_HEADER_SIZE) ||
+            get(header, 4) != BLOCK_MAGIC ||
+            offset + BLOCK_HEADER_SIZE + get(header + 28, 4) > fileSize)
+            break;
+        IIORecordBlock b;
+        b.fileOffset = offset;
+        b.sampleIndex = get(header + 8, 8);
+        b.timestamp = static_cast<int64_t>(get(header + 16, 8));
+        this->index.push_back(b);
+        offset += BLOCK_HEADER_SIZE + get(header + 28, 4);
+    }
+    this->file.clear();
+}
+
+const std::vector<IIOCodecChannel> &IIORecordReader::channels(void) const
+{
+    return this->channelList;
+}
+
+size_t IIORecordReader::step(void) const
+{
+    return this->stepSize;
+}
+
+double IIORecordReader::sampleRate(void) const
+{
+    return this->rate;
+}
+
+const std::vector<IIORecordBlock> &IIORecordReader::blocks(void) const
+{
+    return this->index;
+}
+
+size_t IIORecordReader::find(uint64_t sampleIndex) const
+{
+    auto it = std::upper_bound(this->index.begin(), this->index.end(), sampleIndex,
+        [](uint64_t s, const IIORecordBlock &b){ return s < b.sampleIndex; });
+    return (it == this->index.begin()) ? 0 : (it - this->index.begin()) - 1;
+}
+
+size_t IIORecordReader::read(size_t block, std::vector<uint8_t> &scans)
+{
+    if (block >= this->index.size())
+    {
+        throw Pothos::RangeException("IIORecordReader::read()", "block index out of range");
+    }
+
+    uint8_t header[BLOCK_HEADER_SIZE];
+    this->file.seekg(this->index[block].fileOffset);
+    if (!this->file.read(reinterpret_cast<char *>(header), BLOCK_HEADER_SIZE) ||
+        get(header, 4) != BLOCK_MAGIC)
+    {
+        this->file.clear();
+        throw Pothos::DataFormatException("IIORecordReader::read()", "bad block header");
+    }
+    const bool packed = (get(header + 4, 4) & BLOCK_FLAG_PACKED) != 0;
+    const size_t count = get(header + 24, 4);
+    const size_t length = get(header + 28, 4);
+
+    scans.resize(count * this->stepSize);
+    if (!packed)
+    {
+        if (length != count * this->stepSize)
+        {
+            throw Pothos::DataFormatException("IIORecordReader::read()", "bad block length");
+        }
+        this->file.read(reinterpret_cast<char *>(scans.data()), length);
+    }
+    else
+    {
+        this->encoded.resize(length);
+        this->file.read(reinterpret_cast<char *>(this->encoded.data()), length);
+        if (this->file) this->codec.decode(this->encoded.data(), length, count, scans.data());
+    }
+    if (!this->file)
+    {
+        this->file.clear();
+        throw Pothos::DataFormatException("IIORecordReader::read()", "truncated block");
+    }
+    return count;
+}
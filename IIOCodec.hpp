@@ -0,0 +1,146 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*!
+ * The layout and format of one channel within a recorded scan, mirroring
+ * the fields of struct iio_data_format which are needed to interpret it.
+ */
+struct IIOCodecChannel
+{
+    std::string id;
+    size_t offset;
+    unsigned length;
+    unsigned bits;
+    unsigned shift;
+    bool isSigned;
+    bool isBigEndian;
+};
+
+/*!
+ * IIOBlockCodec losslessly compresses blocks of interleaved IIO scans.
+ *
+ * Each channel is coded independently: samples are read as integers of the
+ * channel's storage size, delta coded against the previous sample, zigzag
+ * mapped so that small negative and positive deltas are both small, and then
+ * bit-packed in groups of 32 using the narrowest width which holds every
+ * delta in the group. Quiet channels therefore cost a few bits per sample.
+ * Blocks do not depend on each other, so any block can be decoded on its
+ * own.
+ */
+class IIOBlockCodec
+{
+private:
+    std::vector<IIOCodecChannel> channels;
+    size_t step;
+    std::vector<uint64_t> scratch;
+
+public:
+    static const size_t GROUP_SIZE = 32;
+
+    IIOBlockCodec(void);
+    IIOBlockCodec(const std::vector<IIOCodecChannel> &channels, size_t step);
+
+    /*!
+     * Encode count scans, replacing the contents of out. Return false if
+     * the packed block would be no smaller than the raw channel samples.
+     */
+    bool encode(const void *scans, size_t count, std::vector<uint8_t> &out);
+
+    /*!
+     * Decode count scans from a block produced by encode(). Bytes of each
+     * scan which belong to no channel are zeroed.
+     */
+    void decode(const uint8_t *in, size_t length, size_t count, void *scans);
+};
+
+/*!
+ * Information about one block of a recording.
+ */
+struct IIORecordBlock
+{
+    uint64_t fileOffset;
+    uint64_t sampleIndex;
+    int64_t timestamp;
+};
+
+/*!
+ * IIORecordWriter appends refills to a recording file, optionally
+ * compressed with IIOBlockCodec. An index of every block is written when
+ * the recording is closed.
+ *
+ * The file starts with a header describing the channel layout, followed by
+ * one block per refill. Each block records the index and host timestamp of
+ * its first sample. All fields are little-endian.
+ */
+class IIORecordWriter
+{
+private:
+    std::ofstream file;
+    IIOBlockCodec codec;
+    size_t step;
+    bool compress;
+    std::vector<IIORecordBlock> index;
+    std::vector<uint8_t> encoded;
+
+public:
+    IIORecordWriter(const std::string &path, const std::vector<IIOCodecChannel> &channels,
+        size_t step, double sampleRate, bool compress);
+    ~IIORecordWriter(void);
+
+    /*!
+     * Append count scans as one block.
+     */
+    void write(const void *scans, size_t count, uint64_t sampleIndex, int64_t timestamp);
+
+    /*!
+     * Write the block index and close the file.
+     */
+    void close(void);
+};
+
+/*!
+ * IIORecordReader provides random access to the blocks of a recording.
+ * If the recording has no index, for example because capture was
+ * interrupted, the index is rebuilt by scanning the blocks.
+ */
+class IIORecordReader
+{
+private:
+    std::ifstream file;
+    std::vector<IIOCodecChannel> channelList;
+    size_t stepSize;
+    double rate;
+    IIOBlockCodec codec;
+    std::vector<IIORecordBlock> index;
+    std::vector<uint8_t> encoded;
+
+    void scanBlocks(uint64_t offset);
+
+public:
+    IIORecordReader(const std::string &path);
+
+    const std::vector<IIOCodecChannel> &channels(void) const;
+
+    size_t step(void) const;
+
+    double sampleRate(void) const;
+
+    const std::vector<IIORecordBlock> &blocks(void) const;
+
+    /*!
+     * Find the block containing the given sample index.
+     */
+    size_t find(uint64_t sampleIndex) const;
+
+    /*!
+     * Decode a block into interleaved scans, returning the number of scans.
+     */
+    size_t read(size_t block, std::vector<uint8_t> &scans);
+};
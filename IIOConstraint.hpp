@@ -0,0 +1,168 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*!
+ * IIOAttrConstraint describes the values accepted by an attribute, as
+ * reported by its companion "<name>_available" attribute. That attribute
+ * holds either a space separated list of values, or a range written as
+ * "[min step max]".
+ */
+class IIOAttrConstraint
+{
+public:
+    enum Kind
+    {
+        None,
+        List,
+        Range,
+    };
+
+private:
+    Kind k;
+    std::vector<std::string> opts;
+    std::vector<double> numericOpts;
+    double lo, inc, hi;
+
+    static bool toNumber(const std::string &s, double &value)
+    {
+        if (s.empty())
+            return false;
+        char *end = nullptr;
+        value = std::strtod(s.c_str(), &end);
+        return end != s.c_str() && *end == '\0';
+    }
+
+    static std::string fromNumber(double value)
+    {
+        std::ostringstream out;
+        out.precision(15);
+        out << value;
+        return out.str();
+    }
+
+public:
+    IIOAttrConstraint(void) : k(None), lo(0.0), inc(0.0), hi(0.0) {}
+
+    /*!
+     * Parse the contents of an "_available" attribute. Text which is neither
+     * a list nor a range gives an unconstrained result.
+     */
+    static IIOAttrConstraint parse(const std::string &text)
+    {
+        IIOAttrConstraint c;
+        std::istringstream in(text);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (in >> token) tokens.push_back(token);
+        if (tokens.empty())
+            return c;
+
+        if (tokens.front().front() == '[' && tokens.back().back() == ']')
+        {
+            tokens.front().erase(0, 1);
+            tokens.back().pop_back();
+            if (tokens.front().empty()) tokens.erase(tokens.begin());
+            if (!tokens.empty() && tokens.back().empty()) tokens.pop_back();
+            double v[3];
+            if (tokens.size() == 3 && toNumber(tokens[0], v[0]) && toNumber(tokens[1], v[1]) && toNumber(tokens[2], v[2]))
+            {
+                c.k = Range;
+                c.lo = v[0];
+                c.inc = v[1];
+                c.hi = v[2];
+            }
+            return c;
+        }
+
+        c.k = List;
+        c.opts = tokens;
+        for (const auto &t : tokens)
+        {
+            double v;
+            if (!toNumber(t, v))
+            {
+                c.numericOpts.clear();
+                break;
+            }
+            c.numericOpts.push_back(v);
+        }
+        return c;
+    }
+
+    Kind kind(void) const
+    {
+        return this->k;
+    }
+
+    /*!
+     * Get the accepted values of a list constraint.
+     */
+    const std::vector<std::string> &options(void) const
+    {
+        return this->opts;
+    }
+
+    double min(void) const
+    {
+        return this->lo;
+    }
+
+    double step(void) const
+    {
+        return this->inc;
+    }
+
+    double max(void) const
+    {
+        return this->hi;
+    }
+
+    /*!
+     * Check a value against the constraint and return the value to write.
+     * Values within a range are snapped to the nearest step, and numeric
+     * list values match by value rather than spelling. Values which are out
+     * of range or not in the list throw without touching the device.
+     */
+    std::string check(const std::string &name, const std::string &value) const
+    {
+        double v = 0.0;
+        const bool numeric = toNumber(value, v);
+
+        if (this->k == Range)
+        {
+            if (!numeric)
+            {
+                throw Pothos::InvalidArgumentException("IIOAttrConstraint::check()", name + ": not a number: " + value);
+            }
+            if (v < this->lo || v > this->hi)
+            {
+                throw Pothos::RangeException("IIOAttrConstraint::check()", name + ": " + value +
+                    " outside [" + fromNumber(this->lo) + ", " + fromNumber(this->hi) + "]");
+            }
+            if (this->inc <= 0.0)
+                return value;
+            const double snapped = std::min(this->hi, this->lo + std::round((v - this->lo) / this->inc) * this->inc);
+            return (snapped == v) ? value : fromNumber(snapped);
+        }
+
+        if (this->k == List)
+        {
+            for (size_t i = 0; i < this->opts.size(); i++)
+            {
+                if (this->opts[i] == value || (numeric && i < this->numericOpts.size() && this->numericOpts[i] == v))
+                    return this->opts[i];
+            }
+            throw Pothos::InvalidArgumentException("IIOAttrConstraint::check()", name + ": " + value + " is not one of the available values");
+        }
+
+        return value;
+    }
+};
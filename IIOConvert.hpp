@@ -0,0 +1,182 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "IIOSupport.hpp"
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/*!
+ * IIOSampleConverter converts raw samples of a single IIO channel, as laid out
+ * in an IIOBuffer, to and from floating point values normalized to [-1, 1).
+ *
+ * Unlike IIOChannel::read(), which copies and converts every sample through
+ * libiio, the converter works directly on strided buffer memory so that it can
+ * be fused into larger processing kernels.
+ */
+class IIOSampleConverter
+{
+private:
+    unsigned int length;
+    unsigned int bits;
+    unsigned int shift;
+    bool isSigned;
+    bool isBigEndian;
+    float scale;
+    float invScale;
+
+    uint64_t load(const void *src) const
+    {
+        switch (this->length) {
+            case 1: {
+                uint8_t v;
+                std::memcpy(&v, src, sizeof(v));
+                return v;
+            }
+            case 2: {
+                uint16_t v;
+                std::memcpy(&v, src, sizeof(v));
+                return this->needsSwap() ? __builtin_bswap16(v) : v;
+            }
+            case 4: {
+                uint32_t v;
+                std::memcpy(&v, src, sizeof(v));
+                return this->needsSwap() ? __builtin_bswap32(v) : v;
+            }
+            default: {
+                uint64_t v;
+                std::memcpy(&v, src, sizeof(v));
+                return this->needsSwap() ? __builtin_bswap64(v) : v;
+            }
+        }
+    }
+
+    void store(uint64_t v, void *dst) const
+    {
+        switch (this->length) {
+            case 1: {
+                uint8_t w = static_cast<uint8_t>(v);
+                std::memcpy(dst, &w, sizeof(w));
+                break;
+            }
+            case 2: {
+                uint16_t w = static_cast<uint16_t>(v);
+                if (this->needsSwap()) w = __builtin_bswap16(w);
+                std::memcpy(dst, &w, sizeof(w));
+                break;
+            }
+            case 4: {
+                uint32_t w = static_cast<uint32_t>(v);
+                if (this->needsSwap()) w = __builtin_bswap32(w);
+                std::memcpy(dst, &w, sizeof(w));
+                break;
+            }
+            default: {
+                if (this->needsSwap()) v = __builtin_bswap64(v);
+                std::memcpy(dst, &v, sizeof(v));
+                break;
+            }
+        }
+    }
+
+    bool needsSwap(void) const
+    {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return !this->isBigEndian;
+#else
+        return this->isBigEndian;
+#endif
+    }
+
+public:
+    IIOSampleConverter(IIOChannel channel)
+    {
+        const struct iio_data_format &format = channel.format();
+        this->length = format.length / 8;
+        this->bits = format.bits;
+        this->shift = format.shift;
+        this->isSigned = format.is_signed;
+        this->isBigEndian = format.is_be;
+        if (this->length != 1 && this->length != 2 && this->length != 4 && this->length != 8)
+        {
+            throw Pothos::DataFormatException("IIOSampleConverter::IIOSampleConverter()", "unsupported sample length for channel " + channel.id());
+        }
+        this->scale = 1.0f / static_cast<float>(uint64_t(1) << (this->bits - 1));
+        this->invScale = 1.0f / this->scale;
+    }
+
+    /*!
+     * Get the size in bytes of one sample of this channel.
+     */
+    size_t sampleSize(void) const
+    {
+        return this->length;
+    }
+
+    /*!
+     * Convert one raw sample to a normalized float.
+     */
+    float toFloat(const void *src) const
+    {
+        uint64_t raw = this->load(src) >> this->shift;
+        if (this->bits < 64)
+        {
+            raw &= (uint64_t(1) << this->bits) - 1;
+        }
+        if (this->isSigned && this->bits < 64 && (raw >> (this->bits - 1)) & 1)
+        {
+            raw |= ~uint64_t(0) << this->bits;
+        }
+        int64_t value = this->isSigned ? static_cast<int64_t>(raw) : static_cast<int64_t>(raw) - (int64_t(1) << (this->bits - 1));
+        return static_cast<float>(value) * this->scale;
+    }
+
+    /*!
+     * Convert one normalized float to a raw sample, saturating values which
+     * fall outside of the channel's range.
+     */
+    void fromFloat(float value, void *dst) const
+    {
+        const float maxValue = this->invScale - 1.0f;
+        float scaled = value * this->invScale;
+        if (scaled > maxValue) scaled = maxValue;
+        if (scaled < -this->invScale) scaled = -this->invScale;
+        int64_t v = static_cast<int64_t>(scaled);
+        if (!this->isSigned)
+        {
+            v += int64_t(1) << (this->bits - 1);
+        }
+        //signed samples keep their sign extension above the data bits
+        uint64_t raw = static_cast<uint64_t>(v);
+        if (!this->isSigned && this->bits < 64)
+        {
+            raw &= (uint64_t(1) << this->bits) - 1;
+        }
+        this->store(raw << this->shift, dst);
+    }
+
+    /*!
+     * Convert count strided raw samples starting at src to normalized floats.
+     */
+    void toFloat(const void *src, ptrdiff_t step, float *dst, size_t count) const
+    {
+        const char *p = static_cast<const char *>(src);
+        for (size_t n = 0; n < count; n++, p += step)
+        {
+            dst[n] = this->toFloat(p);
+        }
+    }
+
+    /*!
+     * Convert count normalized floats to strided raw samples starting at dst.
+     */
+    void fromFloat(const float *src, void *dst, ptrdiff_t step, size_t count) const
+    {
+        char *p = static_cast<char *>(dst);
+        for (size_t n = 0; n < count; n++, p += step)
+        {
+            this->fromFloat(src[n], p);
+        }
+    }
+};
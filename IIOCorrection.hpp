@@ -0,0 +1,178 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "IIOConvert.hpp"
+#include <algorithm>
+#include <complex>
+#include <cmath>
+
+/*!
+ * IIOIQCorrection converts a pair of I/Q channels to complex samples while
+ * removing DC offset and I/Q gain/phase imbalance in the same pass.
+ *
+ * Estimates are accumulated while converting each block and folded into
+ * exponentially weighted running estimates once per block, so the correction
+ * applied to a block always uses the estimates from the blocks before it.
+ */
+class IIOIQCorrection
+{
+private:
+    bool dcEnabled;
+    bool iqEnabled;
+    bool hold;
+    double rate;
+
+    //running estimates
+    double dcI, dcQ;
+    double powerI, powerQ, crossIQ;
+
+    //correction coefficients derived from the estimates
+    float gain, sinPhase, invCosPhase;
+
+    void updateCoefficients(void)
+    {
+        if (this->powerI <= 0.0 || this->powerQ <= 0.0)
+        {
+            this->gain = 1.0f;
+            this->sinPhase = 0.0f;
+            this->invCosPhase = 1.0f;
+            return;
+        }
+        double sinPhase = this->crossIQ / std::sqrt(this->powerI * this->powerQ);
+        sinPhase = std::max(-0.5, std::min(0.5, sinPhase));
+        this->gain = static_cast<float>(std::sqrt(this->powerI / this->powerQ));
+        this->sinPhase = static_cast<float>(sinPhase);
+        this->invCosPhase = static_cast<float>(1.0 / std::sqrt(1.0 - sinPhase * sinPhase));
+    }
+
+public:
+    IIOIQCorrection(void) :
+        dcEnabled(false), iqEnabled(false), hold(false), rate(0.01)
+    {
+        this->reset();
+    }
+
+    /*!
+     * Discard all estimates.
+     */
+    void reset(void)
+    {
+        this->dcI = this->dcQ = 0.0;
+        this->powerI = this->powerQ = this->crossIQ = 0.0;
+        this->updateCoefficients();
+    }
+
+    /*!
+     * Enable or disable DC offset removal.
+     */
+    void setDCEnabled(bool enabled)
+    {
+        this->dcEnabled = enabled;
+    }
+
+    /*!
+     * Enable or disable I/Q gain and phase imbalance correction.
+     */
+    void setIQEnabled(bool enabled)
+    {
+        this->iqEnabled = enabled;
+    }
+
+    /*!
+     * Freeze the current estimates. Corrections are still applied, but
+     * estimates are no longer updated.
+     */
+    void setHold(bool hold)
+    {
+        this->hold = hold;
+    }
+
+    /*!
+     * Set the per-block weight given to new estimates, between 0 and 1.
+     */
+    void setRate(double rate)
+    {
+        if (rate <= 0.0 || rate > 1.0)
+        {
+            throw Pothos::RangeException("IIOIQCorrection::setRate()", "rate must be in (0, 1]");
+        }
+        this->rate = rate;
+    }
+
+    /*!
+     * Get the current DC offset estimate.
+     */
+    std::complex<double> dcOffset(void) const
+    {
+        return std::complex<double>(this->dcI, this->dcQ);
+    }
+
+    /*!
+     * Get the current estimate of the I to Q amplitude ratio.
+     */
+    double gainImbalance(void) const
+    {
+        return this->gain;
+    }
+
+    /*!
+     * Get the current estimate of the quadrature phase error, in radians.
+     */
+    double phaseImbalance(void) const
+    {
+        return std::asin(this->sinPhase);
+    }
+
+    /*!
+     * Convert count samples from the strided I and Q channel data to corrected
+     * complex samples.
+     */
+    void process(const IIOSampleConverter &iConv, const void *iSrc,
+        const IIOSampleConverter &qConv, const void *qSrc,
+        ptrdiff_t step, std::complex<float> *dst, size_t count)
+    {
+        const char *pi = static_cast<const char *>(iSrc);
+        const char *pq = static_cast<const char *>(qSrc);
+
+        //imbalance statistics are always taken on DC-free samples, even
+        //when the DC offset itself is passed through to the output
+        const float dcI = static_cast<float>(this->dcI);
+        const float dcQ = static_cast<float>(this->dcQ);
+        const float outDcI = this->dcEnabled ? 0.0f : dcI;
+        const float outDcQ = this->dcEnabled ? 0.0f : dcQ;
+        const float gain = this->iqEnabled ? this->gain : 1.0f;
+        const float sinPhase = this->iqEnabled ? this->sinPhase : 0.0f;
+        const float invCosPhase = this->iqEnabled ? this->invCosPhase : 1.0f;
+
+        double sumI = 0.0, sumQ = 0.0;
+        double sumII = 0.0, sumQQ = 0.0, sumIQ = 0.0;
+        for (size_t n = 0; n < count; n++, pi += step, pq += step)
+        {
+            const float rawI = iConv.toFloat(pi);
+            const float rawQ = qConv.toFloat(pq);
+            const float i = rawI - dcI;
+            const float q = rawQ - dcQ;
+            sumI += rawI;
+            sumQ += rawQ;
+            sumII += i * i;
+            sumQQ += q * q;
+            sumIQ += i * q;
+            const float outI = i + outDcI;
+            const float outQ = q + outDcQ;
+            dst[n] = std::complex<float>(outI, (outQ * gain - outI * sinPhase) * invCosPhase);
+        }
+
+        if (this->hold || count == 0)
+            return;
+
+        const double a = this->rate;
+        const double inv = 1.0 / count;
+        this->dcI += a * (sumI * inv - this->dcI);
+        this->dcQ += a * (sumQ * inv - this->dcQ);
+        this->powerI += a * (sumII * inv - this->powerI);
+        this->powerQ += a * (sumQQ * inv - this->powerQ);
+        this->crossIQ += a * (sumIQ * inv - this->crossIQ);
+        this->updateCoefficients();
+    }
+};
@@ -0,0 +1,85 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+/*!
+ * IIOFFT is a small in-place radix-2 complex FFT with precomputed twiddle
+ * factors and bit reversal tables, used by the IIO processing kernels.
+ */
+class IIOFFT
+{
+private:
+    size_t n;
+    std::vector<std::complex<float>> twiddles;
+    std::vector<size_t> reversed;
+
+public:
+    IIOFFT(size_t size = 1) : n(size)
+    {
+        if (size == 0 || (size & (size - 1)) != 0)
+        {
+            throw Pothos::InvalidArgumentException("IIOFFT::IIOFFT()", "FFT size must be a power of two");
+        }
+
+        const double pi = std::acos(-1.0);
+        for (size_t i = 0; i < size / 2; i++)
+        {
+            this->twiddles.push_back(std::polar(1.0f, static_cast<float>(-2.0 * pi * i / size)));
+        }
+
+        unsigned int bits = 0;
+        while ((size_t(1) << bits) < size) bits++;
+        this->reversed.resize(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            size_t r = 0;
+            for (unsigned int b = 0; b < bits; b++)
+            {
+                if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+            }
+            this->reversed[i] = r;
+        }
+    }
+
+    /*!
+     * Get the transform size.
+     */
+    size_t size(void) const
+    {
+        return this->n;
+    }
+
+    /*!
+     * Transform data in place. The inverse transform is not normalized.
+     */
+    void transform(std::complex<float> *data, bool inverse = false) const
+    {
+        for (size_t i = 0; i < this->n; i++)
+        {
+            if (i < this->reversed[i]) std::swap(data[i], data[this->reversed[i]]);
+        }
+
+        for (size_t len = 2; len <= this->n; len <<= 1)
+        {
+            const size_t half = len / 2;
+            const size_t stride = this->n / len;
+            for (size_t start = 0; start < this->n; start += len)
+            {
+                for (size_t k = 0; k < half; k++)
+                {
+                    std::complex<float> w = this->twiddles[k * stride];
+                    if (inverse) w = std::conj(w);
+                    const std::complex<float> a = data[start + k];
+                    const std::complex<float> b = data[start + k + half] * w;
+                    data[start + k] = a + b;
+                    data[start + k + half] = a - b;
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,322 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Poco/Error.h>
+#include <poll.h>
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IIOSupport.hpp"
+#include "IIOChannelView.hpp"
+#include "IIOConvert.hpp"
+#include "IIOClock.hpp"
+
+/***********************************************************************
+ * |PothosDoc IIO Fusion
+ *
+ * The IIO fusion block captures several IIO input devices sampling at
+ * different rates, such as the accelerometer, gyroscope and magnetometer of
+ * an IMU, and aligns them onto a common timebase.
+ *
+ * Each refill is time-stamped by correlating the device's hardware timestamp
+ * channel, or its sample count at the nominal "sampling_frequency", with the
+ * host clock. All scan elements of every device are then linearly
+ * interpolated at each output tick and emitted together as one vector
+ * element, in device order and then channel order, normalized to [-1, 1).
+ * The host time of the first output tick is posted as an "rxTime" label.
+ *
+ * |category /IIO
+ * |category /Sources
+ * |keywords iio industrial io imu sensor fusion align resample
+ *
+ * |param deviceIds[Device IDs] The IDs of the IIO devices to align.
+ * |default []
+ *
+ * |param outputRate[Output Rate] The rate of the common timebase.
+ * |units Hz
+ * |default 100.0
+ *
+ * |param bufferSize[Buffer Size] The number of samples to obtain from each
+ * IIO device during each refill operation.
+ * |preview disable
+ * |default 64
+ *
+ * |factory /iio/fusion(deviceIds, outputRate, bufferSize)
+ **********************************************************************/
+class IIOFusion : public Pothos::Block
+{
+private:
+    struct Sensor
+    {
+        IIODevice dev;
+        std::vector<IIOChannel> channels;
+        std::vector<IIOSampleConverter> converters;
+        std::unique_ptr<IIOChannel> timestampChannel;
+        std::unique_ptr<IIOBuffer> buf;
+        double sampleRate;
+        unsigned long long sampleIndex;
+        IIOClockCorrelator clock;
+
+        //host times and interleaved values of samples not yet passed by the output
+        std::vector<long long> times;
+        std::vector<float> values;
+        size_t cursor;
+    };
+
+    std::vector<std::unique_ptr<Sensor>> sensors;
+    double outputRate;
+    size_t bufferSize;
+    size_t numChannels;
+    long long nextTickNs;
+    unsigned long long ticks;
+    long long firstTickNs;
+
+public:
+    IIOFusion(const std::vector<std::string> &deviceIds, const double &outputRate, const size_t &bufferSize)
+        : outputRate(outputRate), bufferSize(bufferSize), numChannels(0), nextTickNs(0), ticks(0), firstTickNs(0)
+    {
+        if (outputRate <= 0.0)
+        {
+            throw Pothos::RangeException("IIOFusion::IIOFusion()", "output rate must be positive");
+        }
+
+        IIOContext& ctx = IIOContext::get();
+        for (const auto &deviceId : deviceIds)
+        {
+            std::unique_ptr<Sensor> sensor;
+            for (auto d : ctx.devices())
+            {
+                if (d.id() == deviceId)
+                {
+                    sensor.reset(new Sensor{d, {}, {}, nullptr, nullptr, 0.0, 0, IIOClockCorrelator(), {}, {}, 0});
+                    break;
+                }
+            }
+            if (!sensor)
+            {
+                throw Pothos::SystemException("IIOFusion::IIOFusion()", "device not found: " + deviceId);
+            }
+
+            for (auto c : sensor->dev.channels())
+            {
+                if (c.isOutput() || !c.isScanElement())
+                    continue;
+                if (c.id() == "timestamp")
+                {
+                    sensor->timestampChannel.reset(new IIOChannel(c));
+                    continue;
+                }
+                sensor->channels.push_back(c);
+                sensor->converters.push_back(IIOSampleConverter(c));
+            }
+            this->numChannels += sensor->channels.size();
+            this->sensors.push_back(std::move(sensor));
+        }
+
+        if (this->numChannels == 0)
+        {
+            throw Pothos::InvalidArgumentException("IIOFusion::IIOFusion()", "no scannable input channels found");
+        }
+        this->setupOutput(0, Pothos::DType("float32", this->numChannels));
+    }
+
+    static Block *make(const std::vector<std::string> &deviceIds, const double &outputRate, const size_t &bufferSize)
+    {
+        return new IIOFusion(deviceIds, outputRate, bufferSize);
+    }
+
+    void activate(void)
+    {
+        for (auto &s : this->sensors)
+        {
+            for (auto c : s->channels) c.enable();
+            if (s->timestampChannel) s->timestampChannel->enable();
+
+            s->sampleRate = 0.0;
+            try
+            {
+                s->sampleRate = std::stod(s->dev.attributes().at("sampling_frequency").value());
+            }
+            catch (const std::exception &) {}
+            if (!s->timestampChannel && s->sampleRate <= 0.0)
+            {
+                throw Pothos::SystemException("IIOFusion::activate()", "device " + s->dev.id() + " has neither a timestamp channel nor a sampling frequency");
+            }
+
+            s->buf.reset(new IIOBuffer(s->dev.createBuffer(this->bufferSize, false)));
+            s->buf->setBlockingMode(false);
+            s->sampleIndex = 0;
+            s->clock.reset();
+            s->times.clear();
+            s->values.clear();
+            s->cursor = 0;
+        }
+        this->nextTickNs = 0;
+        this->ticks = 0;
+    }
+
+    void deactivate(void)
+    {
+        for (auto &s : this->sensors)
+        {
+            s->buf.reset();
+        }
+    }
+
+    void work(void)
+    {
+        //wait for any device to have samples
+        std::vector<struct pollfd> pfds;
+        for (auto &s : this->sensors)
+        {
+            struct pollfd pfd = {
+                .fd = s->buf->fd(),
+                .events = POLLIN,
+                .revents = 0
+            };
+            pfds.push_back(pfd);
+        }
+        struct timespec ts = {
+            .tv_sec = static_cast<time_t>(this->workInfo().maxTimeoutNs/1000000000),
+            .tv_nsec = static_cast<long int>(this->workInfo().maxTimeoutNs % 1000000000)
+        };
+        int ret = ppoll(pfds.data(), pfds.size(), &ts, NULL);
+        if (ret < 0)
+            throw Pothos::SystemException("IIOFusion::work()", "ppoll failed: " + Poco::Error::getMessage(errno));
+        else if (ret == 0)
+            return this->yield();
+
+        for (size_t i = 0; i < this->sensors.size(); i++)
+        {
+            if (pfds[i].revents & POLLIN) this->refill(*this->sensors[i]);
+        }
+
+        this->produce();
+    }
+
+private:
+    void refill(Sensor &s)
+    {
+        const long long startNs = IIOClockCorrelator::now();
+        auto bytes = s.buf->refill();
+        const long long endNs = IIOClockCorrelator::now();
+        const size_t count = bytes / s.buf->step();
+        if (count == 0)
+            return;
+
+        //correlate the first and last sample of the refill with the host clock
+        long long firstNs, lastNs;
+        if (s.timestampChannel)
+        {
+            //in host byte order, and shifted down as the channel's format says
+            IIOChannelView<int64_t> timestamps(*s.buf, *s.timestampChannel);
+            const unsigned shift = s.timestampChannel->format().shift;
+            const long long first = int64_t(timestamps[0]) >> shift;
+            const long long last = int64_t(timestamps[count - 1]) >> shift;
+            s.clock.update(last, s.sampleIndex + count, startNs, endNs);
+            firstNs = s.clock.toHostNs(first);
+            lastNs = s.clock.toHostNs(last);
+        }
+        else
+        {
+            const double period = 1e9 / s.sampleRate;
+            s.clock.update(static_cast<long long>((s.sampleIndex + count - 1) * period), s.sampleIndex + count, startNs, endNs);
+            firstNs = s.clock.toHostNs(static_cast<long long>(s.sampleIndex * period));
+            lastNs = s.clock.toHostNs(static_cast<long long>((s.sampleIndex + count - 1) * period));
+        }
+        s.sampleIndex += count;
+
+        //append the refill, converted and de-interleaved channel by channel
+        //into the sample-major history
+        const size_t nch = s.channels.size();
+        const size_t base = s.times.size();
+        s.times.resize(base + count);
+        s.values.resize((base + count) * nch);
+        for (size_t n = 0; n < count; n++)
+        {
+            s.times[base + n] = (count == 1) ? lastNs : firstNs + static_cast<long long>((lastNs - firstNs) * (static_cast<double>(n) / (count - 1)));
+        }
+        std::vector<float> scratch(count);
+        for (size_t c = 0; c < nch; c++)
+        {
+            s.converters[c].toFloat(s.buf->first(s.channels[c]), s.buf->step(), scratch.data(), count);
+            float *dst = &s.values[base * nch + c];
+            for (size_t n = 0; n < count; n++) dst[n * nch] = scratch[n];
+        }
+    }
+
+    void produce(void)
+    {
+        //the timebase starts once every device has delivered samples
+        for (auto &s : this->sensors)
+        {
+            if (s->times.empty()) return;
+        }
+        if (this->ticks == 0 && this->nextTickNs == 0)
+        {
+            for (auto &s : this->sensors)
+            {
+                this->nextTickNs = std::max(this->nextTickNs, s->times.front());
+            }
+            this->firstTickNs = this->nextTickNs;
+        }
+
+        auto outputPort = this->output(0);
+        float *out = outputPort->buffer().as<float *>();
+        const size_t maxTicks = this->workInfo().minOutElements;
+        size_t produced = 0;
+        while (produced < maxTicks)
+        {
+            //a tick can only be produced once every device has passed it
+            const long long tick = this->nextTickNs;
+            bool ready = true;
+            for (auto &s : this->sensors)
+            {
+                if (s->times.back() < tick) ready = false;
+            }
+            if (!ready) break;
+
+            if (this->ticks == 0)
+            {
+                outputPort->postLabel(Pothos::Label("rxTime", tick, produced));
+            }
+
+            for (auto &s : this->sensors)
+            {
+                const size_t nch = s->channels.size();
+                while (s->cursor + 1 < s->times.size() && s->times[s->cursor + 1] <= tick) s->cursor++;
+                const size_t i0 = s->cursor;
+                const size_t i1 = std::min(i0 + 1, s->times.size() - 1);
+                const long long span = s->times[i1] - s->times[i0];
+                const float frac = (span > 0) ? static_cast<float>(std::max<long long>(0, tick - s->times[i0])) / span : 0.0f;
+                const float *v0 = &s->values[i0 * nch];
+                const float *v1 = &s->values[i1 * nch];
+                for (size_t c = 0; c < nch; c++)
+                {
+                    out[c] = v0[c] + frac * (v1[c] - v0[c]);
+                }
+                out += nch;
+            }
+
+            produced++;
+            this->ticks++;
+            this->nextTickNs = this->firstTickNs + static_cast<long long>(this->ticks * (1e9 / this->outputRate));
+        }
+
+        if (produced > 0) outputPort->produce(produced);
+
+        //discard history that no future tick can reference
+        for (auto &s : this->sensors)
+        {
+            const size_t nch = s->channels.size();
+            s->times.erase(s->times.begin(), s->times.begin() + s->cursor);
+            s->values.erase(s->values.begin(), s->values.begin() + s->cursor * nch);
+            s->cursor = 0;
+        }
+    }
+};
+
+static Pothos::BlockRegistry registerIIOFusion(
+    "/iio/fusion", &IIOFusion::make);
@@ -6,6 +6,8 @@
 #include <Poco/Error.h>
 #include <string>
 #include "IIOSupport.hpp"
+#include "IIOProfile.hpp"
+#include "IIOCalibration.hpp"
 
 #include <typeinfo>
 
@@ -78,12 +80,54 @@ static std::string enumerateIIODevices(void)
     topObject["IIO Version"] = ctx.version();
     topObject["IIO Context Name"] = ctx.name();
     topObject["IIO Context Description"] = ctx.description();
+    topObject["IIO Context Cached"] = ctx.cached();
 
     return topObject.dump();
 }
 
+static IIODevice findProfileDevice(const std::string &deviceId)
+{
+    IIOContext& ctx = IIOContext::get();
+    for (auto d : ctx.devices())
+    {
+        if (d.id() == deviceId)
+            return d;
+    }
+    throw Pothos::NotFoundException("IIOProfile", "device not found: " + deviceId);
+}
+
+static std::string saveIIOProfile(const std::string &deviceId, const std::string &path)
+{
+    return IIOProfile::save(findProfileDevice(deviceId), path);
+}
+
+static size_t loadIIOProfile(const std::string &deviceId, const std::string &path)
+{
+    return IIOProfile::load(findProfileDevice(deviceId), path);
+}
+
+static std::string calibrateIIODevice(const std::string &deviceId)
+{
+    auto dev = findProfileDevice(deviceId);
+    std::vector<IIOChannel> scanElements;
+    for (auto c : dev.channels())
+    {
+        if (c.isScanElement() && c.id() != "timestamp") scanElements.push_back(c);
+    }
+    //streams one direction, preferring inputs
+    std::vector<IIOChannel> inputs, outputs;
+    for (auto c : scanElements) (c.isOutput() ? outputs : inputs).push_back(c);
+    return IIOCalibration().run(dev, inputs.empty() ? outputs : inputs, 0.0);
+}
+
 pothos_static_block(registerIIOInfo)
 {
     Pothos::PluginRegistry::addCall(
         "/devices/iio/info", &enumerateIIODevices);
+    Pothos::PluginRegistry::addCall(
+        "/devices/iio/profile/save", &saveIIOProfile);
+    Pothos::PluginRegistry::addCall(
+        "/devices/iio/profile/load", &loadIIOProfile);
+    Pothos::PluginRegistry::addCall(
+        "/devices/iio/calibrate", &calibrateIIODevice);
 }
@@ -0,0 +1,288 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+/***********************************************************************
+ * IIO loopback latency benchmark
+ *
+ * Streams silence from an output channel to an input channel connected
+ * by a loopback (a cable, or a device with an internal loopback mode),
+ * periodically replaces the start of an output buffer with a full scale
+ * marker pulse, and times how long the marker takes to be seen in the
+ * input stream. Each combination of buffer size, kernel buffer count and
+ * wait strategy is measured separately, and the latency distribution is
+ * printed for each. A marker which is not seen within the timeout is
+ * counted as lost and the next one is sent; the exit status is a failure
+ * when any configuration sees no markers at all.
+ *
+ * The latency covers buffer handoff to the kernel, the device path and
+ * the refill that returns the marker, which is the path the IIO sink and
+ * source blocks add on top of their own work() calls.
+ *
+ * Usage:
+ *     IIOLatencyBench txDevice txChannel rxDevice rxChannel
+ *         [sizes=1024,4096,16384] [counts=2,4] [trials=50] [threshold=0.25]
+ *         [timeout=1000]
+ **********************************************************************/
+
+#include <poll.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IIOSupport.hpp"
+#include "IIOConvert.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t MARKER_LENGTH = 16;
+
+struct BenchConfig
+{
+    size_t bufferSize;
+    unsigned int bufferCount;
+    bool blocking;
+};
+
+struct BenchResult
+{
+    std::vector<double> latencies;
+    size_t lost;
+};
+
+static std::vector<size_t> parseList(const std::string &text)
+{
+    std::vector<size_t> values;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        if (!item.empty()) values.push_back(std::stoul(item));
+    }
+    return values;
+}
+
+static IIODevice findDevice(const std::string &id)
+{
+    for (auto d : IIOContext::get().devices())
+    {
+        if (d.id() == id || d.name() == id) return d;
+    }
+    throw Pothos::NotFoundException("IIOLatencyBench", "device not found: " + id);
+}
+
+static IIOChannel findChannel(IIODevice dev, const std::string &id, bool output)
+{
+    for (auto c : dev.channels())
+    {
+        if (c.id() == id && c.isOutput() == output && c.isScanElement()) return c;
+    }
+    throw Pothos::NotFoundException("IIOLatencyBench", "scan element not found: " + id);
+}
+
+static bool waitBuffer(IIOBuffer &buf, bool blocking, short events)
+{
+    if (blocking)
+        return true;
+    struct pollfd pfd = {
+        .fd = buf.fd(),
+        .events = events,
+        .revents = 0
+    };
+    return poll(&pfd, 1, 1000) > 0;
+}
+
+static long long nowNs(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+/*!
+ * Measure the marker latencies in microseconds for one configuration,
+ * and count the markers which were not seen within the timeout.
+ */
+static BenchResult runConfig(IIODevice txDev, IIOChannel txChan, IIODevice rxDev, IIOChannel rxChan,
+    const BenchConfig &config, size_t trials, float threshold, std::chrono::milliseconds timeout)
+{
+    txDev.setKernelBuffersCount(config.bufferCount);
+    rxDev.setKernelBuffersCount(config.bufferCount);
+    txChan.enable();
+    rxChan.enable();
+    IIOBuffer txBuf(txDev.createBuffer(config.bufferSize, false));
+    IIOBuffer rxBuf(rxDev.createBuffer(config.bufferSize, false));
+    txBuf.setBlockingMode(config.blocking);
+    rxBuf.setBlockingMode(config.blocking);
+
+    IIOSampleConverter txConv(txChan);
+    IIOSampleConverter rxConv(rxChan);
+    std::vector<float> silence(config.bufferSize, 0.0f);
+    std::vector<float> marked(silence);
+    std::fill(marked.begin(), marked.begin() + std::min(MARKER_LENGTH, marked.size()), 0.9f);
+
+    std::atomic<bool> done(false);
+    std::atomic<bool> armed(false);
+    std::atomic<long long> markNs(0);
+    std::atomic<size_t> found(0);
+    BenchResult result;
+    result.lost = 0;
+
+    //the receiver times each marker from the push which carried it
+    std::thread rx([&]
+    {
+        std::vector<float> samples(config.bufferSize);
+        bool inMarker = false;
+        while (!done)
+        {
+            if (!waitBuffer(rxBuf, config.blocking, POLLIN))
+                continue;
+            size_t count;
+            try
+            {
+                count = rxBuf.refill() / rxBuf.step();
+            }
+            catch (const Pothos::Exception &ex)
+            {
+                std::cerr << ex.displayText() << std::endl;
+                return;
+            }
+            const auto rxNs = nowNs();
+            rxConv.toFloat(rxBuf.first(rxChan), rxBuf.step(), samples.data(), count);
+            for (size_t n = 0; n < count; n++)
+            {
+                const bool high = std::fabs(samples[n]) > threshold;
+                bool expected = true;
+                if (high && !inMarker && armed.compare_exchange_strong(expected, false))
+                {
+                    result.latencies.push_back((rxNs - markNs) / 1e3);
+                    found++;
+                }
+                inMarker = high;
+            }
+        }
+    });
+
+    //one marker is in flight at a time, spaced by several buffers of silence
+    const size_t spacing = 2 * config.bufferCount + 2;
+    size_t pushes = 0;
+    const long long timeoutNs = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+    auto deadline = Clock::now() + std::chrono::seconds(5 + trials);
+    try
+    {
+        while (found < trials && Clock::now() < deadline)
+        {
+            //give up on a marker which was lost, so that the next can be sent
+            bool expected = true;
+            if (armed && nowNs() - markNs > timeoutNs && armed.compare_exchange_strong(expected, false))
+            {
+                result.lost++;
+            }
+            if (!waitBuffer(txBuf, config.blocking, POLLOUT))
+                continue;
+            const bool mark = !armed && (pushes % spacing) == 0;
+            txConv.fromFloat(mark ? marked.data() : silence.data(), txBuf.first(txChan), txBuf.step(), config.bufferSize);
+            if (mark)
+            {
+                markNs = nowNs();
+                armed = true;
+            }
+            txBuf.push(config.bufferSize);
+            pushes++;
+        }
+    }
+    catch (...)
+    {
+        done = true;
+        rx.join();
+        throw;
+    }
+    done = true;
+    rx.join();
+    return result;
+}
+
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+        return NAN;
+    const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 5)
+    {
+        std::cerr << "Usage: " << argv[0] << " txDevice txChannel rxDevice rxChannel"
+            " [sizes=1024,4096,16384] [counts=2,4] [trials=50] [threshold=0.25]"
+            " [timeout=1000]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<size_t> sizes{1024, 4096, 16384};
+    std::vector<size_t> counts{2, 4};
+    size_t trials = 50;
+    float threshold = 0.25f;
+    std::chrono::milliseconds timeout(1000);
+    for (int i = 5; i < argc; i++)
+    {
+        const std::string arg(argv[i]);
+        const auto eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+        if (key == "sizes") sizes = parseList(value);
+        else if (key == "counts") counts = parseList(value);
+        else if (key == "trials") trials = std::stoul(value);
+        else if (key == "threshold") threshold = std::stof(value);
+        else if (key == "timeout") timeout = std::chrono::milliseconds(std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool allSeen = true;
+    try
+    {
+        auto txDev = findDevice(argv[1]);
+        auto rxDev = findDevice(argv[3]);
+        auto txChan = findChannel(txDev, argv[2], true);
+        auto rxChan = findChannel(rxDev, argv[4], false);
+
+        std::printf("%10s %8s %9s %7s %5s %10s %10s %10s %10s %10s\n",
+            "bufferSize", "buffers", "wait", "trials", "lost", "min(us)", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+        for (const auto count : counts)
+        {
+            for (const auto size : sizes)
+            {
+                for (const bool blocking : {true, false})
+                {
+                    BenchConfig config;
+                    config.bufferSize = size;
+                    config.bufferCount = static_cast<unsigned int>(count);
+                    config.blocking = blocking;
+                    auto result = runConfig(txDev, txChan, rxDev, rxChan, config, trials, threshold, timeout);
+                    auto &latencies = result.latencies;
+                    std::sort(latencies.begin(), latencies.end());
+                    std::printf("%10zu %8zu %9s %7zu %5zu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                        size, count, blocking ? "blocking" : "poll", latencies.size(), result.lost,
+                        percentile(latencies, 0.0), percentile(latencies, 0.5), percentile(latencies, 0.9),
+                        percentile(latencies, 0.99), percentile(latencies, 1.0));
+                    if (latencies.empty()) allSeen = false;
+                }
+            }
+        }
+    }
+    catch (const Pothos::Exception &ex)
+    {
+        std::cerr << ex.displayText() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return allSeen ? EXIT_SUCCESS : EXIT_FAILURE;
+}
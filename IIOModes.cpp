@@ -0,0 +1,185 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <algorithm>
+#include <iterator>
+#include "IIOModes.hpp"
+#include "IIOChannelView.hpp"
+
+std::vector<IIOCodecChannel> iioScanLayout(IIOBuffer &buf, const std::vector<IIOChannel> &channels)
+{
+    std::vector<IIOCodecChannel> layout;
+    for (auto c : channels)
+    {
+        if (!c.isScanElement())
+            continue;
+        const auto &format = c.format();
+        IIOCodecChannel cc;
+        cc.id = c.id();
+        cc.offset = static_cast<char*>(buf.first(c)) - static_cast<char*>(buf.start());
+        cc.length = format.length;
+        cc.bits = format.bits;
+        cc.shift = format.shift;
+        cc.isSigned = format.is_signed;
+        cc.isBigEndian = format.is_be;
+        layout.push_back(cc);
+    }
+    return layout;
+}
+
+std::vector<std::pair<IIOChannel, IIOChannel>> iioPairScanElements(const std::vector<IIOChannel> &channels, const std::string &caller)
+{
+    std::vector<IIOChannel> scanElements;
+    std::copy_if(channels.begin(), channels.end(), std::back_inserter(scanElements),
+        [](IIOChannel c){ return c.isScanElement(); });
+    if (scanElements.size() % 2 != 0)
+    {
+        throw Pothos::InvalidArgumentException(caller, "complex modes require an even number of channels");
+    }
+    std::vector<std::pair<IIOChannel, IIOChannel>> pairs;
+    for (size_t i = 0; i < scanElements.size(); i += 2)
+    {
+        pairs.push_back(std::make_pair(scanElements[i], scanElements[i + 1]));
+    }
+    return pairs;
+}
+
+void iioPacketLayout(IIOBuffer &buf, const std::vector<IIOChannel> &channels, Pothos::ObjectKwargs &metadata)
+{
+    std::vector<std::string> channelIds;
+    std::vector<size_t> channelOffsets;
+    std::vector<size_t> channelSizes;
+    for (auto c : channels)
+    {
+        if (c.isScanElement())
+        {
+            channelIds.push_back(c.id());
+            channelOffsets.push_back(static_cast<char*>(buf.first(c)) - static_cast<char*>(buf.start()));
+            channelSizes.push_back(c.dtype().size());
+        }
+    }
+    metadata["channels"] = Pothos::Object(channelIds);
+    metadata["offsets"] = Pothos::Object(channelOffsets);
+    metadata["sizes"] = Pothos::Object(channelSizes);
+    metadata["step"] = Pothos::Object(static_cast<size_t>(buf.step()));
+}
+
+void iioCheckPacketLayout(IIOBuffer &buf, const std::vector<IIOChannel> &channels, const Pothos::ObjectKwargs &metadata)
+{
+    const auto step = static_cast<size_t>(buf.step());
+    auto it = metadata.find("step");
+    if (it != metadata.end() && it->second.convert<size_t>() != step)
+    {
+        throw Pothos::DataFormatException("iioCheckPacketLayout()", "packet step " + it->second.toString() +
+            " does not match the buffer step " + std::to_string(step));
+    }
+
+    it = metadata.find("offsets");
+    if (it == metadata.end())
+        return;
+    const auto offsets = it->second.convert<std::vector<size_t>>();
+    std::vector<std::string> ids;
+    it = metadata.find("channels");
+    if (it != metadata.end()) ids = it->second.convert<std::vector<std::string>>();
+
+    const auto layout = iioScanLayout(buf, channels);
+    if (offsets.size() != layout.size() || (!ids.empty() && ids.size() != layout.size()))
+    {
+        throw Pothos::DataFormatException("iioCheckPacketLayout()", "packet has " + std::to_string(offsets.size()) +
+            " channels, the buffer has " + std::to_string(layout.size()));
+    }
+    for (size_t i = 0; i < layout.size(); i++)
+    {
+        if (offsets[i] != layout[i].offset)
+        {
+            throw Pothos::DataFormatException("iioCheckPacketLayout()", "packet channel " + std::to_string(i) +
+                " is at offset " + std::to_string(offsets[i]) + ", not " + std::to_string(layout[i].offset));
+        }
+    }
+}
+
+long long iioCorrelateRefill(IIOClockCorrelator &clock, IIOBuffer &buf, IIOChannel *timestampChannel,
+    double sampleRate, unsigned long long sampleIndex, size_t count, long long refillStartNs, long long refillEndNs)
+{
+    if (count == 0)
+        return refillEndNs;
+
+    if (timestampChannel)
+    {
+        IIOChannelView<int64_t> timestamps(buf, *timestampChannel);
+        clock.update(timestamps[count - 1], sampleIndex + count, refillStartNs, refillEndNs);
+        return clock.toHostNs(timestamps[0]);
+    }
+    if (sampleRate > 0.0)
+    {
+        auto countToNs = [sampleRate](unsigned long long n)
+        {
+            return static_cast<long long>(n * (1e9 / sampleRate));
+        };
+        clock.update(countToNs(sampleIndex + count - 1), sampleIndex + count, refillStartNs, refillEndNs);
+        return clock.toHostNs(countToNs(sampleIndex));
+    }
+    return refillEndNs;
+}
+
+IIOVrtContext iioVrtContext(const std::vector<IIOChannel> &channels, double sampleRate)
+{
+    IIOVrtContext context;
+    if (sampleRate > 0.0) context.sampleRate = sampleRate;
+
+    auto first = std::find_if(channels.begin(), channels.end(),
+        [](IIOChannel c){ return c.isScanElement(); });
+    if (first == channels.end())
+        return context;
+    auto attrs = IIOChannel(*first).attributes();
+    auto read = [&attrs](const std::string &name, double &value)
+    {
+        try
+        {
+            value = std::stod(attrs.at(name).value());
+        }
+        catch (const std::exception &) {}
+    };
+    read("rf_bandwidth", context.bandwidth);
+    read("frequency", context.rfFrequency);
+    read("hardwaregain", context.gain);
+    return context;
+}
+
+IIOComplexInput::IIOComplexInput(IIOChannel i, IIOChannel q)
+    : iConv(i), qConv(q), i(i), q(q)
+{
+}
+
+void IIOComplexInput::convert(IIOBuffer &buf, std::complex<float> *dst, size_t count)
+{
+    this->correction.process(this->iConv, buf.first(this->i),
+        this->qConv, buf.first(this->q), buf.step(), dst, count);
+}
+
+size_t IIOComplexInput::channelize(IIOBuffer &buf, size_t count, const std::vector<size_t> &subbands, std::complex<float> * const *outputs)
+{
+    this->scratch.resize(count);
+    this->convert(buf, this->scratch.data(), count);
+    return this->channelizer.process(this->scratch.data(), count, subbands, outputs);
+}
+
+bool IIOComplexInput::accumulate(IIOBuffer &buf, size_t count)
+{
+    count = std::min(count, this->spectrum.remaining());
+    this->scratch.resize(count);
+    this->convert(buf, this->scratch.data(), count);
+    this->spectrum.process(this->scratch.data(), count);
+    return this->spectrum.ready();
+}
+
+IIOComplexOutput::IIOComplexOutput(IIOChannel i, IIOChannel q)
+    : iConv(i), qConv(q), i(i), q(q)
+{
+}
+
+void IIOComplexOutput::upconvert(const std::complex<float> *src, size_t count, IIOBuffer &buf)
+{
+    this->upconverter.process(src, count, this->iConv, buf.first(this->i),
+        this->qConv, buf.first(this->q), buf.step());
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <complex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "IIOSupport.hpp"
+#include "IIOConvert.hpp"
+#include "IIOCodec.hpp"
+#include "IIOClock.hpp"
+#include "IIOVrt.hpp"
+#include "IIOCorrection.hpp"
+#include "IIOChannelizer.hpp"
+#include "IIOSpectrum.hpp"
+#include "IIOUpconverter.hpp"
+
+/*!
+ * The processing behind the output modes of the IIO source and the input
+ * modes of the IIO sink. It works between IIO buffers and plain memory, so
+ * that the blocks only move samples between buffers and ports.
+ */
+
+/*!
+ * Get the offset and format of each scan element among the channels, as
+ * laid out in the buffer.
+ */
+std::vector<IIOCodecChannel> iioScanLayout(IIOBuffer &buf, const std::vector<IIOChannel> &channels);
+
+/*!
+ * Pair consecutive scan elements among the channels as I and Q. An odd
+ * number of them is an error, reported as coming from caller.
+ */
+std::vector<std::pair<IIOChannel, IIOChannel>> iioPairScanElements(const std::vector<IIOChannel> &channels, const std::string &caller);
+
+/*!
+ * Describe the layout of the buffer in packet metadata: the IDs, offsets
+ * and sizes of the scan elements ("channels", "offsets" and "sizes") and
+ * the bytes between scans ("step").
+ */
+void iioPacketLayout(IIOBuffer &buf, const std::vector<IIOChannel> &channels, Pothos::ObjectKwargs &metadata);
+
+/*!
+ * Check packet metadata written by iioPacketLayout() against the layout of
+ * the buffer. Metadata which is missing is not checked.
+ */
+void iioCheckPacketLayout(IIOBuffer &buf, const std::vector<IIOChannel> &channels, const Pothos::ObjectKwargs &metadata);
+
+/*!
+ * Correlate a refill of count scans, the first of which is sampleIndex,
+ * with the host clock, and return the host time of its first scan in
+ * nanoseconds. Scans are timed by the timestamp scan element if there is
+ * one, or else by the sample rate; with neither, the end of the refill is
+ * returned.
+ */
+long long iioCorrelateRefill(IIOClockCorrelator &clock, IIOBuffer &buf, IIOChannel *timestampChannel,
+    double sampleRate, unsigned long long sampleIndex, size_t count, long long refillStartNs, long long refillEndNs);
+
+/*!
+ * Read the VRT stream context from the "rf_bandwidth", "frequency" and
+ * "hardwaregain" attributes of the first scan element among the channels,
+ * with the sample rate if it is known (non-zero).
+ */
+IIOVrtContext iioVrtContext(const std::vector<IIOChannel> &channels, double sampleRate);
+
+/*!
+ * IIOComplexInput converts an I/Q pair of input scan elements into
+ * corrected complex samples, and optionally channelizes them or accumulates
+ * them into a spectrum.
+ */
+class IIOComplexInput
+{
+private:
+    IIOSampleConverter iConv;
+    IIOSampleConverter qConv;
+    std::vector<std::complex<float>> scratch;
+
+public:
+    IIOChannel i;
+    IIOChannel q;
+    IIOIQCorrection correction;
+    IIOChannelizer channelizer;
+    IIOSpectrum spectrum;
+
+    IIOComplexInput(IIOChannel i, IIOChannel q);
+
+    /*!
+     * Convert the first count scans of the buffer into dst.
+     */
+    void convert(IIOBuffer &buf, std::complex<float> *dst, size_t count);
+
+    /*!
+     * Convert the first count scans of the buffer and channelize them into
+     * the selected sub-bands. Returns the samples written per sub-band.
+     */
+    size_t channelize(IIOBuffer &buf, size_t count, const std::vector<size_t> &subbands, std::complex<float> * const *outputs);
+
+    /*!
+     * Convert only as many of the first count scans of the buffer as the
+     * spectrum still needs, and accumulate them. Returns true once the
+     * spectrum is ready.
+     */
+    bool accumulate(IIOBuffer &buf, size_t count);
+};
+
+/*!
+ * IIOComplexOutput upconverts complex baseband samples into an I/Q pair of
+ * output scan elements.
+ */
+class IIOComplexOutput
+{
+private:
+    IIOSampleConverter iConv;
+    IIOSampleConverter qConv;
+
+public:
+    IIOChannel i;
+    IIOChannel q;
+    IIOUpconverter upconverter;
+
+    IIOComplexOutput(IIOChannel i, IIOChannel q);
+
+    /*!
+     * Upconvert count samples into the start of the buffer, which receives
+     * count * upconverter.interpolation() scans.
+     */
+    void upconvert(const std::complex<float> *src, size_t count, IIOBuffer &buf);
+};
@@ -0,0 +1,166 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * The layout of one channel within the interleaved samples of a frame.
+ */
+struct IIONetChannel
+{
+    std::string id;
+    uint16_t offset;
+    uint16_t size;
+};
+
+/*!
+ * IIONetFrame describes the header preceding each buffer of interleaved
+ * samples streamed between the IIO network sink and source blocks.
+ *
+ * On the wire, all fields are big-endian:
+ *
+ *     u32 magic ("IIOS")   u16 version        u16 number of channels
+ *     u32 header length    u32 step (bytes per scan)
+ *     u64 sequence number  u64 index of first sample
+ *     i64 timestamp (ns)   u32 flags          u32 payload length
+ *     per channel: u16 offset, u16 sample size, u8 id length, id
+ *
+ * followed by payload length bytes of samples. Payloads are limited to
+ * MAX_PAYLOAD_SIZE bytes, so that a corrupt header cannot make the
+ * receiver allocate without bound.
+ */
+struct IIONetFrame
+{
+    static const uint32_t MAGIC = 0x494f4f53;
+    static const uint16_t VERSION = 1;
+    static const size_t FIXED_HEADER_SIZE = 48;
+    static const uint32_t FLAG_OVERFLOW = 1 << 0;
+    static const size_t MAX_PAYLOAD_SIZE = 1 << 28;
+
+    uint32_t step;
+    uint64_t sequence;
+    uint64_t sampleIndex;
+    int64_t timestamp;
+    uint32_t flags;
+    uint32_t payloadLength;
+    std::vector<IIONetChannel> channels;
+
+    IIONetFrame(void) : step(0), sequence(0), sampleIndex(0), timestamp(0), flags(0), payloadLength(0) {}
+
+    /*!
+     * Encode the header, including the channel table.
+     */
+    std::vector<uint8_t> encode(void) const
+    {
+        size_t length = FIXED_HEADER_SIZE;
+        for (const auto &c : this->channels) length += 5 + c.id.size();
+
+        std::vector<uint8_t> out;
+        out.reserve(length);
+        put(out, MAGIC, 4);
+        put(out, VERSION, 2);
+        put(out, this->channels.size(), 2);
+        put(out, length, 4);
+        put(out, this->step, 4);
+        put(out, this->sequence, 8);
+        put(out, this->sampleIndex, 8);
+        put(out, static_cast<uint64_t>(this->timestamp), 8);
+        put(out, this->flags, 4);
+        put(out, this->payloadLength, 4);
+        for (const auto &c : this->channels)
+        {
+            if (c.id.size() > 255)
+            {
+                throw Pothos::RangeException("IIONetFrame::encode()", "channel id too long: " + c.id);
+            }
+            put(out, c.offset, 2);
+            put(out, c.size, 2);
+            put(out, c.id.size(), 1);
+            out.insert(out.end(), c.id.begin(), c.id.end());
+        }
+        return out;
+    }
+
+    /*!
+     * Get the total header length from the first FIXED_HEADER_SIZE bytes,
+     * which must fit the channel table they describe.
+     */
+    static size_t headerLength(const uint8_t *fixed)
+    {
+        if (get(fixed, 4) != MAGIC || get(fixed + 4, 2) != VERSION)
+        {
+            throw Pothos::DataFormatException("IIONetFrame::headerLength()", "bad frame magic or version");
+        }
+        const size_t length = get(fixed + 8, 4);
+        const size_t numChannels = get(fixed + 6, 2);
+        if (length < FIXED_HEADER_SIZE + 5 * numChannels || length > FIXED_HEADER_SIZE + 260 * numChannels)
+        {
+            throw Pothos::DataFormatException("IIONetFrame::headerLength()", "bad frame header length");
+        }
+        return length;
+    }
+
+    /*!
+     * Decode a complete header of the given length.
+     */
+    static IIONetFrame decode(const uint8_t *header, size_t length)
+    {
+        IIONetFrame frame;
+        const size_t numChannels = get(header + 6, 2);
+        frame.step = get(header + 12, 4);
+        frame.sequence = get(header + 16, 8);
+        frame.sampleIndex = get(header + 24, 8);
+        frame.timestamp = static_cast<int64_t>(get(header + 32, 8));
+        frame.flags = get(header + 40, 4);
+        frame.payloadLength = get(header + 44, 4);
+        if (frame.payloadLength > MAX_PAYLOAD_SIZE)
+        {
+            throw Pothos::DataFormatException("IIONetFrame::decode()", "frame payload too large");
+        }
+
+        size_t pos = FIXED_HEADER_SIZE;
+        for (size_t i = 0; i < numChannels; i++)
+        {
+            if (pos + 5 > length)
+            {
+                throw Pothos::DataFormatException("IIONetFrame::decode()", "truncated channel table");
+            }
+            IIONetChannel c;
+            c.offset = get(header + pos, 2);
+            c.size = get(header + pos + 2, 2);
+            const size_t idLength = header[pos + 4];
+            pos += 5;
+            if (pos + idLength > length)
+            {
+                throw Pothos::DataFormatException("IIONetFrame::decode()", "truncated channel table");
+            }
+            c.id.assign(reinterpret_cast<const char *>(header + pos), idLength);
+            pos += idLength;
+            frame.channels.push_back(c);
+        }
+        return frame;
+    }
+
+private:
+    static void put(std::vector<uint8_t> &out, uint64_t value, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; i++)
+        {
+            out.push_back(static_cast<uint8_t>(value >> (8 * (bytes - 1 - i))));
+        }
+    }
+
+    static uint64_t get(const uint8_t *in, size_t bytes)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++)
+        {
+            value = (value << 8) | in[i];
+        }
+        return value;
+    }
+};
@@ -0,0 +1,383 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Poco/Error.h>
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IIONet.hpp"
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
+/***********************************************************************
+ * |PothosDoc IIO Network Sink
+ *
+ * The IIO network sink is a TCP server which streams IIO buffers to any
+ * number of connected clients, such as the IIO network source.
+ *
+ * Its input accepts the packets produced by the IIO source in "PACKET"
+ * output mode, and any other message is an error. Each packet is sent as one frame: a compact header carrying
+ * the channel layout, sequence number, sample index, timestamp and overflow
+ * flag, followed by the interleaved samples. Where the kernel supports it,
+ * payloads are sent with MSG_ZEROCOPY, and each packet is held until the
+ * kernel reports that it has finished with the payload memory.
+ *
+ * Client sockets never block the sink: frames which a client cannot take
+ * yet are queued for it, and once a client is too far behind, frames are
+ * dropped for that client only, and counted by the droppedFrames probe.
+ * The network source sees the gap in the sequence numbers and marks it
+ * with an "rxDiscontinuity" label.
+ *
+ * |category /IIO
+ * |category /Sinks
+ * |keywords iio industrial io network tcp server stream
+ *
+ * |param bindAddress[Bind Address] The local IPv4 address to listen on.
+ * |default "0.0.0.0"
+ *
+ * |param port[Port] The TCP port to listen on.
+ * |default 7300
+ *
+ * |factory /iio/netsink(bindAddress, port)
+ **********************************************************************/
+class IIONetSink : public Pothos::Block
+{
+private:
+    //a frame queued for a client, with the bytes of the header and then
+    //the payload already sent
+    struct Outgoing
+    {
+        std::vector<uint8_t> header;
+        Pothos::Packet packet;
+        size_t sent;
+        bool zerocopySent;
+    };
+
+    struct Client
+    {
+        int fd;
+        bool zerocopy;
+        uint32_t nextSendId;
+        std::deque<Outgoing> backlog;
+        //packets whose payload is still referenced by the kernel, keyed by
+        //the id of the last zerocopy send covering them
+        std::deque<std::pair<uint32_t, Pothos::Packet>> pending;
+    };
+
+    std::string bindAddress;
+    int port;
+    int listenFd;
+    std::vector<Client> clients;
+    uint64_t sequence;
+    unsigned long long droppedCount;
+
+    static const size_t MAX_PENDING = 64;
+    static const size_t MAX_BACKLOG = 16;
+
+public:
+    IIONetSink(const std::string &bindAddress, const int &port)
+        : bindAddress(bindAddress), port(port), listenFd(-1), sequence(0), droppedCount(0)
+    {
+        this->setupInput(0);
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIONetSink, droppedFrames));
+        this->registerProbe("droppedFrames");
+    }
+
+    static Block *make(const std::string &bindAddress, const int &port)
+    {
+        return new IIONetSink(bindAddress, port);
+    }
+
+    /*!
+     * Get the number of frames dropped for clients which fell behind.
+     */
+    unsigned long long droppedFrames(void) const
+    {
+        return this->droppedCount;
+    }
+
+    void activate(void)
+    {
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(this->port));
+        if (inet_pton(AF_INET, this->bindAddress.c_str(), &addr.sin_addr) != 1)
+        {
+            throw Pothos::InvalidArgumentException("IIONetSink::activate()", "invalid bind address: " + this->bindAddress);
+        }
+
+        this->listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (this->listenFd < 0)
+        {
+            throw Pothos::SystemException("IIONetSink::activate()", "socket: " + Poco::Error::getMessage(errno));
+        }
+        int one = 1;
+        setsockopt(this->listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(this->listenFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 ||
+            listen(this->listenFd, 8) < 0)
+        {
+            int err = errno;
+            close(this->listenFd);
+            this->listenFd = -1;
+            throw Pothos::SystemException("IIONetSink::activate()", "bind/listen: " + Poco::Error::getMessage(err));
+        }
+        this->sequence = 0;
+    }
+
+    void deactivate(void)
+    {
+        for (auto &c : this->clients)
+        {
+            close(c.fd);
+        }
+        this->clients.clear();
+        if (this->listenFd >= 0)
+        {
+            close(this->listenFd);
+            this->listenFd = -1;
+        }
+    }
+
+    void work(void)
+    {
+        this->acceptClients();
+        for (auto it = this->clients.begin(); it != this->clients.end();)
+        {
+            this->reapCompletions(*it);
+            if (this->flush(*it))
+            {
+                ++it;
+            }
+            else
+            {
+                close(it->fd);
+                it = this->clients.erase(it);
+            }
+        }
+
+        auto inputPort = this->input(0);
+        if (!inputPort->hasMessage())
+            return;
+        auto msg = inputPort->popMessage();
+        if (msg.type() != typeid(Pothos::Packet))
+        {
+            throw Pothos::DataFormatException("IIONetSink::work()", "expected a Pothos::Packet, got " + msg.toString());
+        }
+        const auto &packet = msg.extract<Pothos::Packet>();
+
+        const auto frame = this->makeFrame(packet);
+        const auto header = frame.encode();
+        this->sequence++;
+
+        for (auto it = this->clients.begin(); it != this->clients.end();)
+        {
+            if (this->queueFrame(*it, header, packet))
+            {
+                ++it;
+            }
+            else
+            {
+                close(it->fd);
+                it = this->clients.erase(it);
+            }
+        }
+    }
+
+private:
+    IIONetFrame makeFrame(const Pothos::Packet &packet)
+    {
+        IIONetFrame frame;
+        frame.sequence = this->sequence;
+        if (packet.payload.length > IIONetFrame::MAX_PAYLOAD_SIZE)
+        {
+            throw Pothos::RangeException("IIONetSink::work()", "packet payload too large for a frame");
+        }
+        frame.payloadLength = static_cast<uint32_t>(packet.payload.length);
+
+        auto meta = [&packet](const std::string &key) -> const Pothos::Object *
+        {
+            auto it = packet.metadata.find(key);
+            return (it == packet.metadata.end()) ? nullptr : &it->second;
+        };
+        if (auto step = meta("step")) frame.step = static_cast<uint32_t>(step->convert<size_t>());
+        if (auto index = meta("sampleIndex")) frame.sampleIndex = index->convert<unsigned long long>();
+        if (auto timestamp = meta("timestamp")) frame.timestamp = timestamp->convert<long long>();
+        if (auto overflow = meta("overflow")) frame.flags |= overflow->convert<bool>() ? IIONetFrame::FLAG_OVERFLOW : 0;
+
+        auto ids = meta("channels");
+        auto offsets = meta("offsets");
+        auto sizes = meta("sizes");
+        if (ids && offsets && sizes)
+        {
+            const auto &idVec = ids->extract<std::vector<std::string>>();
+            const auto &offsetVec = offsets->extract<std::vector<size_t>>();
+            const auto &sizeVec = sizes->extract<std::vector<size_t>>();
+            for (size_t i = 0; i < idVec.size() && i < offsetVec.size() && i < sizeVec.size(); i++)
+            {
+                //the frame header holds offsets and sizes in 16 bits
+                if (offsetVec[i] > 0xffff || sizeVec[i] > 0xffff)
+                {
+                    throw Pothos::RangeException("IIONetSink::work()", "channel layout too large for a frame: " + idVec[i]);
+                }
+                IIONetChannel c;
+                c.id = idVec[i];
+                c.offset = static_cast<uint16_t>(offsetVec[i]);
+                c.size = static_cast<uint16_t>(sizeVec[i]);
+                frame.channels.push_back(c);
+            }
+        }
+        if (frame.step == 0)
+        {
+            throw Pothos::DataFormatException("IIONetSink::work()", "packet has no IIO channel layout");
+        }
+        return frame;
+    }
+
+    void acceptClients(void)
+    {
+        while (true)
+        {
+            int fd = accept4(this->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return;
+
+            Client c;
+            c.fd = fd;
+            c.nextSendId = 0;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            c.zerocopy = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+            this->clients.push_back(std::move(c));
+        }
+    }
+
+    void reapCompletions(Client &c)
+    {
+        while (!c.pending.empty())
+        {
+            char control[128];
+            struct msghdr msg = {};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (recvmsg(c.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+                return;
+
+            for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm))
+            {
+                const auto *err = reinterpret_cast<const struct sock_extended_err *>(CMSG_DATA(cm));
+                if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                    continue;
+
+                //ee_info..ee_data is the range of completed send ids
+                while (!c.pending.empty() && static_cast<int32_t>(c.pending.front().first - err->ee_data) <= 0)
+                {
+                    c.pending.pop_front();
+                }
+            }
+        }
+    }
+
+    /*!
+     * Send as much of the client's backlog as its socket takes without
+     * blocking. Returns false if the connection has failed.
+     */
+    bool flush(Client &c)
+    {
+        while (!c.backlog.empty())
+        {
+            auto &o = c.backlog.front();
+            const uint8_t *data;
+            size_t length;
+            int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+            if (o.sent < o.header.size())
+            {
+                //the small header is copied, only the payload is sent by reference
+                data = o.header.data() + o.sent;
+                length = o.header.size() - o.sent;
+                flags |= MSG_MORE;
+            }
+            else
+            {
+                const size_t offset = o.sent - o.header.size();
+                data = o.packet.payload.as<const uint8_t *>() + offset;
+                length = o.packet.payload.length - offset;
+                if (c.zerocopy) flags |= MSG_ZEROCOPY;
+            }
+
+            if (length > 0)
+            {
+                ssize_t ret = send(c.fd, data, length, flags);
+                if (ret < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        return true;
+                    if (errno == ENOBUFS && (flags & MSG_ZEROCOPY))
+                    {
+                        //out of optmem for zerocopy notifications, fall back to copying
+                        c.zerocopy = false;
+                        continue;
+                    }
+                    return false;
+                }
+                if (flags & MSG_ZEROCOPY)
+                {
+                    c.nextSendId++;
+                    o.zerocopySent = true;
+                }
+                o.sent += ret;
+                if (static_cast<size_t>(ret) < length)
+                    continue;
+            }
+            if (o.sent < o.header.size() + o.packet.payload.length)
+                continue;
+
+            if (o.zerocopySent)
+            {
+                c.pending.push_back(std::make_pair(c.nextSendId - 1, o.packet));
+            }
+            c.backlog.pop_front();
+        }
+        return true;
+    }
+
+    bool queueFrame(Client &c, const std::vector<uint8_t> &header, const Pothos::Packet &packet)
+    {
+        //bound the memory held on behalf of slow clients by dropping their
+        //frames, rather than waiting for them
+        if (c.backlog.size() >= MAX_BACKLOG || c.pending.size() >= MAX_PENDING)
+        {
+            this->droppedCount++;
+            return true;
+        }
+
+        Outgoing o;
+        o.header = header;
+        o.packet = packet;
+        o.sent = 0;
+        o.zerocopySent = false;
+        c.backlog.push_back(std::move(o));
+        return this->flush(c);
+    }
+};
+
+static Pothos::BlockRegistry registerIIONetSink(
+    "/iio/netsink", &IIONetSink::make);
@@ -0,0 +1,264 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Poco/Error.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <poll.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IIONet.hpp"
+
+/***********************************************************************
+ * |PothosDoc IIO Network Source
+ *
+ * The IIO network source connects to an IIO network sink and reconstructs
+ * the ports of the remote IIO source, one output port per channel, from the
+ * frames it receives.
+ *
+ * The correlated time of the first sample of each frame is posted as an
+ * "rxTime" label. Frames flagged as following an overflow on the remote
+ * device, or following a gap in the frame sequence, are marked with an
+ * "rxDiscontinuity" label. Frames larger than the output buffers are
+ * produced over several calls. Frames are also received over several
+ * calls, each waiting for no longer than the work timeout, so that a
+ * stalled sink never stops the block from being deactivated.
+ *
+ * |category /IIO
+ * |category /Sources
+ * |keywords iio industrial io network tcp client stream
+ *
+ * |param host[Host] The host name or address of the IIO network sink.
+ * |default "localhost"
+ *
+ * |param port[Port] The TCP port of the IIO network sink.
+ * |default 7300
+ *
+ * |param channelIds[Channel IDs] The IDs of the remote channels to output.
+ * |default []
+ *
+ * |param dtype[Data Type] The data type of the remote channels.
+ * |widget DTypeChooser(int8=1,int16=1,int32=1,int64=1,uint8=1,uint16=1,uint32=1,uint64=1)
+ * |default "int16"
+ * |preview disable
+ *
+ * |factory /iio/netsource(host, port, channelIds, dtype)
+ **********************************************************************/
+class IIONetSource : public Pothos::Block
+{
+private:
+    std::string host;
+    int port;
+    std::vector<std::string> channelIds;
+    int fd;
+    std::unique_ptr<IIONetFrame> frame;
+    std::vector<uint8_t> payload;
+    size_t payloadCursor;
+    bool payloadReady;
+    uint64_t nextSequence;
+
+    std::vector<uint8_t> header;
+    size_t headerReceived;
+    size_t payloadReceived;
+
+    /*!
+     * Receive the rest of buf, of which received bytes have already
+     * arrived, waiting for no longer than the work timeout. Returns false
+     * if the bytes have not all arrived yet, so that work() can yield and
+     * carry on receiving when it is called again.
+     */
+    bool recvSome(std::vector<uint8_t> &buf, size_t &received)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(this->workInfo().maxTimeoutNs);
+        while (received < buf.size())
+        {
+            ssize_t ret = recv(this->fd, buf.data() + received, buf.size() - received, MSG_DONTWAIT);
+            if (ret == 0)
+            {
+                throw Pothos::IOException("IIONetSource::work()", "connection closed by server");
+            }
+            if (ret > 0)
+            {
+                received += ret;
+                continue;
+            }
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                throw Pothos::SystemException("IIONetSource::work()", "recv: " + Poco::Error::getMessage(errno));
+            }
+
+            //wait for more bytes until the deadline
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+                return false;
+            struct pollfd pfd = {
+                .fd = this->fd,
+                .events = POLLIN,
+                .revents = 0
+            };
+            ret = poll(&pfd, 1, static_cast<int>(remaining.count()));
+            if (ret < 0 && errno != EINTR)
+                throw Pothos::SystemException("IIONetSource::work()", "poll: " + Poco::Error::getMessage(errno));
+            else if (ret == 0)
+                return false;
+        }
+        return true;
+    }
+
+public:
+    IIONetSource(const std::string &host, const int &port,
+        const std::vector<std::string> &channelIds, const Pothos::DType &dtype)
+        : host(host), port(port), channelIds(channelIds), fd(-1), payloadCursor(0), payloadReady(false), nextSequence(0),
+          headerReceived(0), payloadReceived(0)
+    {
+        for (const auto &id : channelIds)
+        {
+            this->setupOutput(id, dtype);
+        }
+    }
+
+    static Block *make(const std::string &host, const int &port,
+        const std::vector<std::string> &channelIds, const Pothos::DType &dtype)
+    {
+        return new IIONetSource(host, port, channelIds, dtype);
+    }
+
+    void activate(void)
+    {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo *result = nullptr;
+        int ret = getaddrinfo(this->host.c_str(), std::to_string(this->port).c_str(), &hints, &result);
+        if (ret != 0)
+        {
+            throw Pothos::SystemException("IIONetSource::activate()", "getaddrinfo: " + std::string(gai_strerror(ret)));
+        }
+
+        int err = 0;
+        for (auto ai = result; ai != nullptr; ai = ai->ai_next)
+        {
+            this->fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+            if (this->fd < 0)
+                continue;
+            if (connect(this->fd, ai->ai_addr, ai->ai_addrlen) == 0)
+                break;
+            err = errno;
+            close(this->fd);
+            this->fd = -1;
+        }
+        freeaddrinfo(result);
+        if (this->fd < 0)
+        {
+            throw Pothos::SystemException("IIONetSource::activate()", "connect: " + Poco::Error::getMessage(err));
+        }
+
+        int one = 1;
+        setsockopt(this->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        this->frame.reset();
+        this->header.assign(IIONetFrame::FIXED_HEADER_SIZE, 0);
+        this->headerReceived = 0;
+        this->payloadReady = false;
+        this->nextSequence = 0;
+    }
+
+    void deactivate(void)
+    {
+        if (this->fd >= 0)
+        {
+            close(this->fd);
+            this->fd = -1;
+        }
+    }
+
+    void work(void)
+    {
+        //read the next frame header, whose fixed part gives its length,
+        //over as many calls as it takes to arrive
+        if (!this->frame)
+        {
+            if (!this->recvSome(this->header, this->headerReceived))
+                return this->yield();
+            if (this->header.size() == IIONetFrame::FIXED_HEADER_SIZE)
+            {
+                this->header.resize(IIONetFrame::headerLength(this->header.data()));
+                if (!this->recvSome(this->header, this->headerReceived))
+                    return this->yield();
+            }
+            this->frame.reset(new IIONetFrame(IIONetFrame::decode(this->header.data(), this->header.size())));
+            this->header.resize(IIONetFrame::FIXED_HEADER_SIZE);
+            this->headerReceived = 0;
+            this->payload.resize(this->frame->payloadLength);
+            this->payloadReceived = 0;
+        }
+
+        //read the samples of the frame, which are then produced in as many
+        //pieces as the output buffers need
+        const size_t samples = this->frame->step ? this->frame->payloadLength / this->frame->step : 0;
+        if (!this->payloadReady)
+        {
+            if (!this->recvSome(this->payload, this->payloadReceived))
+                return this->yield();
+            this->payloadReady = true;
+            this->payloadCursor = 0;
+        }
+        const size_t count = std::min(samples - this->payloadCursor, this->workInfo().minOutElements);
+        if (count == 0 && samples != 0)
+            return;
+
+        //the labels belong to the first sample of the frame
+        const bool first = this->payloadCursor == 0;
+        const bool discontinuity = first && ((this->frame->flags & IIONetFrame::FLAG_OVERFLOW) ||
+            (this->nextSequence != 0 && this->frame->sequence != this->nextSequence));
+        if (first) this->nextSequence = this->frame->sequence + 1;
+
+        //demultiplex the interleaved samples into the channel ports
+        for (auto outputPort : this->outputs())
+        {
+            const IIONetChannel *layout = nullptr;
+            for (const auto &c : this->frame->channels)
+            {
+                if (c.id == outputPort->name()) layout = &c;
+            }
+            if (!layout)
+            {
+                throw Pothos::NotFoundException("IIONetSource::work()", "channel not in stream: " + outputPort->name());
+            }
+            const size_t size = std::min<size_t>(layout->size, outputPort->dtype().size());
+            const uint8_t *src = this->payload.data() + this->payloadCursor * this->frame->step + layout->offset;
+            uint8_t *dst = outputPort->buffer().as<uint8_t *>();
+            for (size_t n = 0; n < count; n++)
+            {
+                std::memcpy(dst + n * outputPort->dtype().size(), src + n * this->frame->step, size);
+            }
+
+            if (first)
+            {
+                outputPort->postLabel(Pothos::Label("rxTime", static_cast<long long>(this->frame->timestamp), 0));
+            }
+            if (discontinuity)
+            {
+                outputPort->postLabel(Pothos::Label("rxDiscontinuity", static_cast<unsigned long long>(this->frame->sampleIndex), 0));
+            }
+            outputPort->produce(count);
+        }
+
+        this->payloadCursor += count;
+        if (this->payloadCursor < samples)
+            return;
+        this->payloadReady = false;
+        this->frame.reset();
+    }
+};
+
+static Pothos::BlockRegistry registerIIONetSource(
+    "/iio/netsource", &IIONetSource::make);
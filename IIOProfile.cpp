@@ -0,0 +1,234 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework.hpp>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "IIOProfile.hpp"
+
+#include <json.hpp>
+using json = nlohmann::json;
+
+static bool isAvailableAttr(const std::string &name)
+{
+    static const std::string suffix = "_available";
+    return name.size() > suffix.size() &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+template <class T>
+static json saveAttrs(IIOAttrs<T> attrs)
+{
+    json attrObject = json::object();
+    for (const auto &v : attrs.values())
+    {
+        if (isAvailableAttr(v.first) || !attrs.at(v.first).writable())
+            continue;
+        attrObject[v.first] = v.second;
+    }
+    return attrObject;
+}
+
+std::string IIOProfile::save(IIODevice dev, const std::string &path)
+{
+    json profile;
+    profile["device"] = dev.id();
+    profile["name"] = dev.name();
+    profile["attributes"] = saveAttrs(dev.attributes());
+
+    auto &channels = profile["channels"];
+    channels["input"] = json::object();
+    channels["output"] = json::object();
+    for (auto c : dev.channels())
+    {
+        channels[c.isOutput() ? "output" : "input"][c.id()] = saveAttrs(c.attributes());
+    }
+
+    const auto text = profile.dump(4);
+    if (!path.empty())
+    {
+        std::ofstream out(path);
+        out << text << std::endl;
+        if (!out)
+        {
+            throw Pothos::WriteFileException("IIOProfile::save()", path);
+        }
+    }
+    return text;
+}
+
+//attributes which others depend on, in the order they are written: filters
+//and rates before the bandwidths they limit, LO frequencies and the gain
+//control mode before the gains whose range they set; everything else after
+static const char *writeOrder[] = {
+    "trx_rate_governor",
+    "filter_fir_config",
+    "filter_fir_en",
+    "oversampling_ratio",
+    "sampling_frequency",
+    "rf_bandwidth",
+    "rf_port_select",
+    "frequency",
+    "gain_control_mode",
+    "hardwaregain",
+};
+
+static int writeRank(const std::string &name)
+{
+    const auto begin = std::begin(writeOrder);
+    const auto end = std::end(writeOrder);
+    return static_cast<int>(std::find(begin, end, name) - begin);
+}
+
+namespace
+{
+    //the current values of one device or channel, read in bulk when they
+    //are first needed and again after a write which may have changed them
+    struct ProfileGroup
+    {
+        std::function<std::vector<std::pair<std::string, std::string>>(void)> read;
+        std::map<std::string, std::string> values;
+        bool valid;
+    };
+
+    //a saved attribute value, ranked by the write order table
+    struct ProfileWrite
+    {
+        int rank;
+        size_t group;
+        std::string attr;
+        std::string name;
+        std::string value;
+        std::function<void(const std::string &)> write;
+    };
+}
+
+template <class T>
+static void planWrites(IIOAttrs<T> attrs, const json &profileAttrs, int channelRank, const std::string &prefix,
+    std::vector<ProfileGroup> &groups, std::vector<ProfileWrite> &writes)
+{
+    if (!profileAttrs.is_object())
+        return;
+
+    ProfileGroup group;
+    group.read = [attrs](void) mutable { return attrs.values(); };
+    group.valid = false;
+    groups.push_back(group);
+
+    for (auto it = profileAttrs.begin(); it != profileAttrs.end(); ++it)
+    {
+        //saved values are written verbatim, without snapping to constraints
+        auto attr = attrs.at(it.key());
+        ProfileWrite w;
+        w.rank = writeRank(it.key()) * 2 + channelRank;
+        w.group = groups.size() - 1;
+        w.attr = it.key();
+        w.name = prefix + it.key();
+        w.value = it.value().is_string() ? it.value().template get<std::string>() : it.value().dump();
+        w.write = [attr](const std::string &v) mutable { attr.write(v.data(), v.size()); };
+        writes.push_back(w);
+    }
+}
+
+size_t IIOProfile::load(IIODevice dev, const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        throw Pothos::FileNotFoundException("IIOProfile::load()", path);
+    }
+    json profile;
+    try
+    {
+        in >> profile;
+    }
+    catch (const std::exception &ex)
+    {
+        throw Pothos::DataFormatException("IIOProfile::load()", path + ": " + ex.what());
+    }
+
+    std::vector<ProfileGroup> groups;
+    std::vector<ProfileWrite> writes;
+    if (profile.count("attributes"))
+    {
+        planWrites(dev.attributes(), profile["attributes"], 0, "", groups, writes);
+    }
+    if (profile.count("channels"))
+    {
+        const auto &channels = profile["channels"];
+        for (auto c : dev.channels())
+        {
+            const char *dir = c.isOutput() ? "output" : "input";
+            if (!channels.count(dir) || !channels[dir].count(c.id()))
+                continue;
+            planWrites(c.attributes(), channels[dir][c.id()], 1, c.id() + ".", groups, writes);
+        }
+    }
+
+    //device attributes go before channel attributes of the same rank
+    std::stable_sort(writes.begin(), writes.end(),
+        [](const ProfileWrite &a, const ProfileWrite &b) { return a.rank < b.rank; });
+
+    size_t written = 0;
+    std::vector<ProfileWrite> failed;
+    for (auto &w : writes)
+    {
+        //skip attributes which already hold the saved value, comparing
+        //against values read after any earlier write that changed them
+        auto &group = groups[w.group];
+        if (!group.valid)
+        {
+            const auto values = group.read();
+            group.values = std::map<std::string, std::string>(values.begin(), values.end());
+            group.valid = true;
+        }
+        auto cur = group.values.find(w.attr);
+        if (cur != group.values.end() && cur->second == w.value)
+            continue;
+
+        try
+        {
+            w.write(w.value);
+            written++;
+        }
+        catch (const Pothos::Exception &)
+        {
+            failed.push_back(w);
+        }
+
+        bool everywhere = false;
+        if (!IIOContextRaw::hasDependents(w.attr.c_str(), everywhere))
+            continue;
+        if (!everywhere)
+        {
+            group.valid = false;
+            continue;
+        }
+        for (auto &g : groups) g.valid = false;
+    }
+
+    std::string errors;
+    for (auto &w : failed)
+    {
+        try
+        {
+            w.write(w.value);
+            written++;
+        }
+        catch (const Pothos::Exception &ex)
+        {
+            errors += "\n" + w.name + " = " + w.value + ": " + ex.message();
+        }
+    }
+    if (!errors.empty())
+    {
+        throw Pothos::DataFormatException("IIOProfile::load()", "failed to restore" + errors);
+    }
+    return written;
+}
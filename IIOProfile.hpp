@@ -0,0 +1,45 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <string>
+#include "IIOSupport.hpp"
+
+/*!
+ * IIOProfile captures the writable attributes of a device and its channels
+ * as JSON, and restores them.
+ *
+ * A profile has the form:
+ *
+ *     {"device": id, "name": name, "attributes": {attr: value, ...},
+ *      "channels": {"input": {id: {attr: value, ...}, ...}, "output": {...}}}
+ */
+class IIOProfile
+{
+public:
+    /*!
+     * Read the writable attributes of the device and its channels, using
+     * bulk reads where available. The profile is also written to path,
+     * unless it is empty.
+     */
+    static std::string save(IIODevice dev, const std::string &path);
+
+    /*!
+     * Restore a profile read from path. Attributes which already hold the
+     * profile value are skipped, and the rest are written verbatim, without
+     * checking them against their constraints, in dependency order: a fixed
+     * table puts filters and rates before bandwidths, and LO frequencies
+     * and the gain control mode before gains, with all other attributes
+     * after those. Whether an attribute already holds its value is decided
+     * just before its turn, from values read again after any earlier write
+     * which can change other attributes, such as a rate which limits the
+     * bandwidth. Writes which fail are retried once after the others, as
+     * they may depend on a later attribute. Returns the number of
+     * attributes written.
+     *
+     * Remote contexts cannot tell which attributes are read-only, so their
+     * profiles hold every attribute, and read-only ones whose value has
+     * changed since the profile was saved fail to restore.
+     */
+    static size_t load(IIODevice dev, const std::string &path);
+};
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <Pothos/Framework.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+
+/*!
+ * IIOBufferRecovery tracks the recovery of a stream from transient buffer
+ * errors, such as those returned by a device after a link reset, so that a
+ * block can recreate its buffer rather than failing the whole topology.
+ *
+ * Attempts to recreate the buffer are spaced by a backoff which starts at
+ * one millisecond and doubles after each failure, up to one second. Once
+ * the maximum number of consecutive attempts has failed, the error is
+ * thrown.
+ *
+ * Only the buffer is recreated, from the same device; the device and the
+ * context are never recreated. Errors which leave them unusable, such as
+ * ENODEV once the device has gone away, are therefore not recoverable.
+ * Neither is a lost connection to a remote context, unless libiio
+ * reconnects it when the buffer is created again.
+ */
+class IIOBufferRecovery
+{
+private:
+    size_t maxAttempts;
+    size_t attempt;
+    bool recovering;
+    long long nextNs;
+    unsigned long long count;
+    std::string error;
+
+    static const long long MIN_BACKOFF_NS = 1000000;
+    static const long long MAX_BACKOFF_NS = 1000000000;
+
+    void schedule(long long nowNs)
+    {
+        long long backoff = MIN_BACKOFF_NS;
+        for (size_t i = 0; i < this->attempt && backoff < MAX_BACKOFF_NS; i++) backoff *= 2;
+        this->nextNs = nowNs + (backoff < MAX_BACKOFF_NS ? backoff : MAX_BACKOFF_NS);
+    }
+
+public:
+    IIOBufferRecovery(void) : maxAttempts(8), attempt(0), recovering(false), nextNs(0), count(0) {}
+
+    /*!
+     * Set the number of consecutive attempts made before giving up.
+     * Zero disables recovery.
+     */
+    void setMaxAttempts(size_t maxAttempts)
+    {
+        this->maxAttempts = maxAttempts;
+    }
+
+    /*!
+     * Check if an error code returned by a buffer operation is one that
+     * recreating the buffer from the same device may clear.
+     */
+    static bool recoverable(int code)
+    {
+        return code == EIO || code == ETIMEDOUT || code == EPIPE || code == EBUSY;
+    }
+
+    /*!
+     * Start recovering from a failed buffer operation. Returns false if the
+     * error should be thrown instead.
+     */
+    bool begin(const Pothos::Exception &ex, long long nowNs)
+    {
+        if (this->maxAttempts == 0 || this->recovering || !recoverable(ex.code()))
+            return false;
+        this->recovering = true;
+        this->attempt = 0;
+        this->error = ex.displayText();
+        this->schedule(nowNs);
+        return true;
+    }
+
+    bool active(void) const
+    {
+        return this->recovering;
+    }
+
+    /*!
+     * Get the time until the next attempt is due, or zero if it is due now.
+     */
+    long long waitNs(long long nowNs) const
+    {
+        return (this->nextNs > nowNs) ? this->nextNs - nowNs : 0;
+    }
+
+    /*!
+     * Record a failed attempt, throwing if there are no attempts left.
+     */
+    void failed(const Pothos::Exception &ex, long long nowNs)
+    {
+        this->error = ex.displayText();
+        if (++this->attempt >= this->maxAttempts)
+        {
+            this->recovering = false;
+            throw Pothos::SystemException("IIOBufferRecovery::failed()", "buffer recovery failed after " +
+                std::to_string(this->attempt) + " attempts: " + this->error);
+        }
+        this->schedule(nowNs);
+    }
+
+    /*!
+     * Record that the buffer has been recreated.
+     */
+    void succeeded(void)
+    {
+        this->recovering = false;
+        this->count++;
+    }
+
+    void reset(void)
+    {
+        this->recovering = false;
+        this->attempt = 0;
+    }
+
+    /*!
+     * Get the number of successful recoveries.
+     */
+    unsigned long long recoveries(void) const
+    {
+        return this->count;
+    }
+};
@@ -7,17 +7,74 @@
 #include <memory>
 #include <string>
 #include <cstring>
+#include <set>
 #include <vector>
-#include "IIOSupport.hpp"
-
-#include <json.hpp>
-using json = nlohmann::json;
+#include <complex>
+#include "IIOBlock.hpp"
+#include "IIOModes.hpp"
+#include "IIOClock.hpp"
 
 /***********************************************************************
  * |PothosDoc IIO Sink
  *
  * The IIO source forwards an input sample stream to an IIO output device.
  *
+ * Device and channel attributes are read and written with the
+ * deviceAttribute(name), setDeviceAttribute(name, value),
+ * channelAttribute(channel, name) and setChannelAttribute(channel, name,
+ * value) calls. The per-attribute calls "deviceAttribute[name]",
+ * "setdeviceAttribute[name]", "channelAttribute[channel][name]" and
+ * "setChannelAttribute[channel][name]" are registered the first time they
+ * are called. Probes for the getters of the device attributes and of the
+ * attributes of the selected channels are registered when the block is
+ * created, so that they can be connected to before they are first called.
+ *
+ * Large or binary attributes, such as FIR filter configurations, are read
+ * whole with deviceAttributeData(name) and channelAttributeData(channel,
+ * name), and written from a file in one operation with
+ * loadDeviceAttribute(name, path) and loadChannelAttribute(channel, name,
+ * path).
+ *
+ * Attribute writes are checked against the values listed by the
+ * attribute's "_available" companion, if it has one, before reaching the
+ * device: values within a "[min step max]" range are snapped to the step,
+ * and values outside the range or list are rejected. The parsed constraints
+ * are cached, and are returned as JSON by deviceAttributeConstraint(name)
+ * and channelAttributeConstraint(channel, name) for building widgets.
+ *
+ * Device registers are accessed through the driver's debugfs interface with
+ * regRead(address) and regWrite(address, value), or in bulk with
+ * regReadBatch(addresses) and regWriteBatch(addresses, values), which handle
+ * a whole list of registers in one call. Other debug attributes are listed
+ * by debugAttributeNames() and accessed with debugAttribute(name) and
+ * setDebugAttribute(name, value).
+ *
+ * saveProfile(path) captures the writable attributes of the device and its
+ * channels as JSON, which is returned and also written to path unless it is
+ * empty. loadProfile(path) restores a saved profile, skipping attributes
+ * which already hold the saved value and writing the rest in dependency
+ * order, and returns the number of attributes written.
+ *
+ * Instead of polling attribute probes, watchDeviceAttribute(name) and
+ * watchChannelAttribute(channel, name) monitor attributes which may be
+ * changed by the driver or by other processes. Each change is emitted on
+ * the attributeChanged signal with the name of the attribute's getter,
+ * such as "deviceAttribute[name]", and its new value. Changes are queued
+ * by the watcher and emitted from work(), which the sink only runs when
+ * its input has samples or packets: while the input is idle, changes are
+ * held back, and only the latest value of each attribute is emitted once
+ * input resumes. Attributes whose drivers support sysfs notification
+ * are waited on, and the rest are read at an interval which backs off
+ * while they are not changing.
+ * unwatchDeviceAttribute(name) and unwatchChannelAttribute(channel, name)
+ * stop watching.
+ *
+ * calibrate() measures streaming throughput across a grid of buffer sizes,
+ * kernel buffer counts and wait strategies, using short bursts on the
+ * block's channels, and returns the measurements and a recommended
+ * configuration as JSON. It can only be called while the block is not
+ * streaming.
+ *
  * |category /IIO
  * |category /Sinks
  * |keywords iio industrial io adc sdr
@@ -44,194 +101,227 @@ using json = nlohmann::json;
  * increase latency.
  * |preview disable
  * |default 2048
- * 
+ *
+ * |param inputMode[Input Mode] How samples are accepted for the IIO device.
+ * <ul>
+ * <li>"STREAM" multiplexes one input port per enabled scan element.</li>
+ * <li>"PACKET" accepts Pothos::Packet messages on the "packet" input port.
+ * Each packet payload must hold whole scans of interleaved samples laid out
+ * as in the IIO buffer, such as the packets produced by the IIO source in
+ * packet mode. Each packet is pushed to the device as one buffer; packets
+ * larger than the buffer size are split over several pushes. Messages
+ * which are not packets, and packets whose "step" or "offsets" metadata
+ * do not match the buffer layout, are errors.</li>
+ * <li>"UPCONVERT" pairs consecutive enabled scan elements as I and Q and
+ * accepts normalized complex float baseband samples on a port named after
+ * the I channel with an "_iq" suffix, for example "voltage0_iq". Samples are interpolated and frequency shifted while being
+ * written into the IIO buffer, so the full-rate signal only ever exists in
+ * device buffer memory.</li>
+ * </ul>
+ * |preview disable
+ * |default "STREAM"
+ * |widget DropDown()
+ * |option [Stream] "STREAM"
+ * |option [Packet] "PACKET"
+ * |option [Upconvert] "UPCONVERT"
+ * <br>
+ * The input mode is set with setInputMode(inputMode), which sets up the
+ * ports of the mode and resets the upconverter settings below, so it is
+ * called before them, and only while the block is not streaming. The
+ * "STREAM" ports are set up when the block is created, as the ports cannot
+ * be removed again. Each mode has port names of its own, so ports set up
+ * for an earlier mode remain, but are unused.
+ *
+ * |param interpolation[Interpolation] The ratio of the device sample rate to
+ * the input sample rate. Only applies to the "UPCONVERT" input mode.
+ * |preview disable
+ * |default 1
+ *
+ * |param interpolationTaps[Interpolation Taps] Prototype lowpass filter taps
+ * for the interpolator, at the device sample rate. If no taps are specified,
+ * a windowed-sinc prototype is designed automatically.
+ * Only applies to the "UPCONVERT" input mode.
+ * |preview disable
+ * |default []
+ *
+ * |param frequency[NCO Frequency] The frequency shift applied after
+ * interpolation, as a fraction of the device sample rate.
+ * Only applies to the "UPCONVERT" input mode.
+ * |preview disable
+ * |default 0.0
+ *
+ * |param recoveryAttempts[Recovery Attempts] When a buffer operation fails
+ * with a transient device error, such as EIO or ETIMEDOUT after a link
+ * reset, the buffer is destroyed and recreated in the block instead of
+ * stopping the topology. The device and the context are not recreated, so
+ * errors which leave them unusable, such as ENODEV once the device has
+ * gone away, still stop it. The samples of the failed push are dropped,
+ * and counted by the droppedSamples probe.
+ * Attempts back off from 1 ms up to 1 s, and the error is thrown once this
+ * many consecutive attempts have failed. Zero disables recovery.
+ * |preview disable
+ * |default 8
+ *
+ * |param bufferHook[Buffer Hook] The name of a buffer hook plugin, which
+ * processes the raw scans of each buffer in place after it has been filled
+ * and before it is pushed to the device. Hooks are registered under
+ * /iio/hooks/<name>. Leave empty for no hook.
+ * |preview valid
+ * |default ""
+ *
+ * |param bufferHookArgs[Buffer Hook Args] An arguments string passed to the
+ * buffer hook when it is created.
+ * |preview valid
+ * |default ""
+ *
  * |factory /iio/sink(deviceId, channelIds, enablePorts, bufferSize)
+ * |setter setInputMode(inputMode)
+ * |setter setInterpolation(interpolation, interpolationTaps)
+ * |setter setFrequency(frequency)
+ * |setter setBufferHook(bufferHook, bufferHookArgs)
+ * |setter setRecoveryAttempts(recoveryAttempts)
  **********************************************************************/
-class IIOSink : public Pothos::Block
+class IIOSink : public IIOBlock
 {
 private:
-    std::unique_ptr<IIODevice> dev;
-    std::unique_ptr<IIOBuffer> buf;
-    std::vector<IIOChannel> channels;
-    bool enablePorts;
-    size_t bufferSize;
+    enum class InputMode
+    {
+        Stream,
+        Packet,
+        Upconvert,
+    };
+
+    std::vector<IIOComplexOutput> iqPairs;
+    std::set<std::string> portNames;
+    std::vector<Pothos::InputPort *> modePorts;
+    InputMode inputMode;
+    Pothos::BufferChunk pendingPayload;
+    unsigned long long sampleIndex;
+    unsigned long long droppedCount;
+
+    static InputMode parseInputMode(const std::string &inputMode)
+    {
+        if (inputMode == "STREAM") return InputMode::Stream;
+        if (inputMode == "PACKET") return InputMode::Packet;
+        if (inputMode == "UPCONVERT") return InputMode::Upconvert;
+        throw Pothos::InvalidArgumentException("IIOSink::setInputMode()", "unknown input mode: " + inputMode);
+    }
+
 public:
     IIOSink(const std::string &deviceId, const std::vector<std::string> &channelIds,
         const bool &enablePorts, const size_t &bufferSize)
-        : enablePorts(enablePorts), bufferSize(bufferSize)
+        : IIOBlock("IIOSink", deviceId, channelIds, enablePorts, bufferSize, true), inputMode(InputMode::Stream), sampleIndex(0), droppedCount(0)
     {
-        //expose overlay hook
-        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSink, overlay));
+        //expose input mode and upconverter controls
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSink, setInputMode));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSink, setInterpolation));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSink, setFrequency));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSink, droppedSamples));
+        this->registerProbe("droppedSamples");
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSink, getFrequency));
+        this->registerProbe("getFrequency");
+
+        this->setupPorts();
+    }
 
-        //get libiio context
-        IIOContext& ctx = IIOContext::get();
+    void setInputMode(const std::string &inputMode)
+    {
+        if (this->isActive())
+        {
+            throw Pothos::IllegalStateException("IIOSink::setInputMode()", "cannot change the input mode while streaming");
+        }
+        this->inputMode = parseInputMode(inputMode);
+        this->setupPorts();
+    }
 
-        //if deviceId is blank, create a partial object that exposes the
-        //overlay hook for the gui but cannot be activated
-        if (deviceId == "") {
+private:
+    void setupPorts(void)
+    {
+        this->modePorts.clear();
+        if (!this->dev)
             return;
-        }
 
-        //find iio device
-        for (auto d : ctx.devices())
+        //set up input ports for scannable output channels
+        if (this->enablePorts && this->inputMode == InputMode::Stream)
         {
-            if (d.id() == deviceId)
+            for (auto c : this->channels)
             {
-                this->dev = std::unique_ptr<IIODevice>(new IIODevice(d));
-                break;
+                if (c.isScanElement()) this->setupModeInput(c.id(), c.dtype());
             }
         }
-        if (!this->dev)
-        {
-            throw Pothos::SystemException("IIOSink::IIOSink()", "device not found");
-        }
 
-        //set up probes/setters for device attributes 
-        for (auto a : this->dev->attributes())
+        //set up a single packet port carrying all scannable output channels
+        if (this->enablePorts && this->inputMode == InputMode::Packet && this->haveScanElements())
         {
-            Pothos::Callable attrGetter(&IIOSink::getDeviceAttribute);
-            Pothos::Callable attrSetter(&IIOSink::setDeviceAttribute);
-            attrGetter.bind(std::ref(*this), 0);
-            attrGetter.bind(a, 1);
-            attrSetter.bind(std::ref(*this), 0);
-            attrSetter.bind(a, 1);
-
-            std::string getDeviceAttrName = "deviceAttribute[" + a.name() + "]";
-            std::string setDeviceAttrName = "setdeviceAttribute[" + a.name() + "]";
-            this->registerCallable(getDeviceAttrName, attrGetter);
-            this->registerCallable(setDeviceAttrName, attrSetter);
-            this->registerProbe(getDeviceAttrName);
+            this->setupModeInput("packet", Pothos::DType());
         }
 
-        //set up probes/ports for selected input channels
-        for (auto c : this->dev->channels())
+        //pair up scannable output channels as I/Q and set up complex ports
+        this->iqPairs.clear();
+        if (this->enablePorts && this->inputMode == InputMode::Upconvert)
         {
-            if (!c.isOutput())
-                continue;
-            std::string cId = c.id();
-            if (channelIds.size() > 0 && std::none_of(channelIds.begin(), channelIds.end(),
-                    [cId](std::string s){ return s == cId; }))
-                continue;
-            this->channels.push_back(c);
-
-            //set up input ports for scannable input channels
-            if (c.isScanElement() && this->enablePorts)
+            for (auto pair : iioPairScanElements(this->channels, "IIOSink::setInputMode()"))
             {
-                this->setupInput(c.id(), c.dtype());
-            }
-
-            //set up probes/setters for channel attributes
-            for (auto a : c.attributes())
-            {
-                Pothos::Callable attrGetter(&IIOSink::getChannelAttribute);
-                Pothos::Callable attrSetter(&IIOSink::setChannelAttribute);
-                attrGetter.bind(std::ref(*this), 0);
-                attrGetter.bind(a, 1);
-                attrSetter.bind(std::ref(*this), 0);
-                attrSetter.bind(a, 1);
-
-                std::string getChannelAttrName = "channelAttribute[" + c.id() + "][" + a.name() + "]";
-                std::string setChannelAttrName = "setChannelAttribute[" + c.id() + "][" + a.name() + "]";
-                this->registerCallable(getChannelAttrName, attrGetter);
-                this->registerCallable(setChannelAttrName, attrSetter);
-                this->registerProbe(getChannelAttrName);
+                this->iqPairs.push_back(IIOComplexOutput(pair.first, pair.second));
+                this->setupModeInput(complexPortName(pair.first), Pothos::DType(typeid(std::complex<float>)));
             }
         }
     }
 
-    std::string overlay(void) const
+    //ports are only set up once, as a mode may be selected again
+    void setupModeInput(const std::string &name, const Pothos::DType &dtype)
     {
-        IIOContext& ctx = IIOContext::get();
-
-        json topObj;
-        auto &params = topObj["params"];
-
-        //configure deviceId dropdown options
-        json deviceIdParam;
-        deviceIdParam["key"] = "deviceId";
-        auto &deviceIdOpts = deviceIdParam["options"];
-        deviceIdParam["widgetKwargs"]["editable"] = false;
-        deviceIdParam["widgetType"] = "DropDown";
-
-        //add empty device option associated
-        json emptyOption;
-        emptyOption["name"] = "";
-        emptyOption["value"] = "\"\"";
-        deviceIdOpts.push_back(emptyOption);
-
-        //enumerate iio devices
-        for (auto d : ctx.devices())
-        {
-            //use the standard label convention, but fall-back on driver/serial
-            std::string name;
-
-            json option;
-            option["name"] = d.name() + " (" + d.id() + ")";
-            option["value"] = "\"" + d.id() + "\"";
-            deviceIdOpts.push_back(option);
-        }
-        params.push_back(deviceIdParam);
+        if (this->portNames.insert(name).second) this->setupInput(name, dtype);
+        this->modePorts.push_back(this->input(name));
+    }
 
-        return topObj.dump();
+    static std::string complexPortName(IIOChannel c)
+    {
+        return c.id() + "_iq";
     }
 
+public:
     static Block *make(const std::string &deviceId, const std::vector<std::string> &channelIds,
         const bool &enablePorts, const size_t &bufferSize)
     {
         return new IIOSink(deviceId, channelIds, enablePorts, bufferSize);
     }
 
-    std::string getDeviceAttribute(IIOAttr<IIODevice> a)
+    void setInterpolation(const size_t interpolation, const std::vector<float> &taps)
     {
-        return a.value();
+        if (this->bufferSize % interpolation != 0)
+        {
+            throw Pothos::InvalidArgumentException("IIOSink::setInterpolation()", "buffer size must be a multiple of the interpolation");
+        }
+        for (auto &p : this->iqPairs)
+        {
+            const double frequency = p.upconverter.getFrequency();
+            p.upconverter = IIOUpconverter(interpolation, taps);
+            p.upconverter.setFrequency(frequency);
+        }
     }
 
-    void setDeviceAttribute(IIOAttr<IIODevice> a, Pothos::Object value)
+    void setFrequency(const double frequency)
     {
-        a = value.toString();
+        for (auto &p : this->iqPairs) p.upconverter.setFrequency(frequency);
     }
 
-    std::string getChannelAttribute(IIOAttr<IIOChannel> a)
+    double getFrequency(void) const
     {
-        return a.value();
+        return this->iqPairs.empty() ? 0.0 : this->iqPairs.front().upconverter.getFrequency();
     }
 
-    void setChannelAttribute(IIOAttr<IIOChannel> a, Pothos::Object value)
+    unsigned long long droppedSamples(void) const
     {
-        a = value.toString();
+        return this->droppedCount;
     }
 
     void activate(void)
     {
-        if (!this->dev)
-        {
-            throw Pothos::SystemException("IIOSink::activate()", "no device specified");
-        }
-
-        bool haveScanElements = false;
-        if (this->buf) {
-            this->buf.reset();
-        }
-
-        for (auto c : this->channels)
-        {
-            c.enable();
-
-            if (c.isScanElement())
-            {
-                haveScanElements = true;
-            }
-        }
-
-        //create sample buffer if we've got any scan elements
-        if (haveScanElements && this->enablePorts) {
-            this->buf = std::unique_ptr<IIOBuffer>(new IIOBuffer(std::move(this->dev->createBuffer(this->bufferSize, false))));
-            if (!this->buf)
-            {
-                throw Pothos::SystemException("IIOSink::activate()", "buffer creation failed");
-            }
-            this->buf->setBlockingMode(false);
-        }
+        this->createBuffer();
+        for (auto &p : this->iqPairs) p.upconverter.reset();
+        this->sampleIndex = 0;
+        this->recovery.reset();
     }
 
     void deactivate(void)
@@ -239,13 +329,42 @@ public:
         if (this->buf) {
             this->buf.reset();
         }
+        this->pendingPayload = Pothos::BufferChunk();
     }
 
     void work(void)
     {
-        auto sample_count = this->workInfo().minInElements;
- 
+        this->emitAttributeChanges();
+        auto sample_count = this->minInputElements();
+
+        if (this->recovery.active() && !this->recoverBuffer())
+            return;
+
         if (this->buf) {
+            //wait for a packet before waiting on the device
+            if (this->inputMode == InputMode::Packet && !this->pendingPayload)
+            {
+                auto inputPort = this->input("packet");
+                if (!inputPort->hasMessage())
+                    return;
+                auto msg = inputPort->popMessage();
+                if (msg.type() != typeid(Pothos::Packet))
+                {
+                    throw Pothos::DataFormatException("IIOSink::work()", "expected a Pothos::Packet, got " + msg.toString());
+                }
+                const auto &packet = msg.extract<Pothos::Packet>();
+                //packets carry their layout, which must match the buffer's
+                iioCheckPacketLayout(*this->buf, this->channels, packet.metadata);
+                const auto &payload = packet.payload;
+                if (payload.length % this->buf->step() != 0)
+                {
+                    throw Pothos::DataFormatException("IIOSink::work()", "packet payload is not a whole number of scans");
+                }
+                if (payload.length == 0)
+                    return;
+                this->pendingPayload = payload;
+            }
+
             //wait for samples
             struct pollfd pfd = {
                 .fd = this->buf->fd(),
@@ -262,6 +381,40 @@ public:
             else if (ret == 0)
                 return this->yield();
 
+            //copy the next buffer's worth of packet payload in one pass,
+            //keeping any remainder for the following push
+            if (this->inputMode == InputMode::Packet)
+            {
+                auto step = static_cast<size_t>(this->buf->step());
+                auto bytes = std::min(this->pendingPayload.length, this->bufferSize * step);
+                std::memcpy(this->buf->start(), this->pendingPayload.as<const void*>(), bytes);
+                this->pendingPayload.address += bytes;
+                this->pendingPayload.length -= bytes;
+                if (this->pendingPayload.length == 0)
+                    this->pendingPayload = Pothos::BufferChunk();
+                this->pushBuffer(bytes / step);
+                return;
+            }
+
+            //interpolate and upconvert straight into the device buffer
+            if (this->inputMode == InputMode::Upconvert)
+            {
+                if (this->iqPairs.empty())
+                    return;
+                const size_t interpolation = this->iqPairs.front().upconverter.interpolation();
+                const size_t count = std::min<size_t>(sample_count, this->bufferSize / interpolation);
+                if (count == 0)
+                    return;
+                for (auto &p : this->iqPairs)
+                {
+                    auto inputPort = this->input(complexPortName(p.i));
+                    p.upconvert(inputPort->buffer().as<const std::complex<float>*>(), count, *this->buf);
+                    inputPort->consume(count);
+                }
+                this->pushBuffer(count * interpolation);
+                return;
+            }
+
             //consume samples
             for (auto c : this->channels)
             {
@@ -275,8 +428,43 @@ public:
             }
 
             //push new samples to iio device
+            this->pushBuffer(sample_count);
+        }
+    }
+
+private:
+    //the samples available on the stream ports of the current mode,
+    //ignoring any ports left over from an earlier mode
+    size_t minInputElements(void)
+    {
+        if (this->inputMode == InputMode::Packet || this->modePorts.empty())
+            return 0;
+        size_t count = ~size_t(0);
+        for (auto inputPort : this->modePorts)
+        {
+            count = std::min(count, inputPort->elements());
+        }
+        return count;
+    }
+
+    void pushBuffer(size_t sample_count)
+    {
+        this->runHook(sample_count, this->sampleIndex, 0);
+        try
+        {
             this->buf->push(sample_count);
         }
+        catch (const Pothos::SystemException &ex)
+        {
+            if (!this->recovery.begin(ex, IIOClockCorrelator::now()))
+                throw;
+            this->buf.reset();
+
+            //the samples were consumed from the inputs but never sent
+            this->droppedCount += sample_count;
+            return;
+        }
+        this->sampleIndex += sample_count;
     }
 };
 
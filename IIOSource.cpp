@@ -3,21 +3,81 @@
 
 #include <Poco/Error.h>
 #include <poll.h>
+#include <time.h>
 #include <algorithm>
+#include <cassert>
 #include <memory>
 #include <string>
 #include <cstring>
+#include <set>
 #include <vector>
-#include "IIOSupport.hpp"
-
-#include <json.hpp>
-using json = nlohmann::json;
+#include <complex>
+#include "IIOBlock.hpp"
+#include "IIOModes.hpp"
+#include "IIOClock.hpp"
+#include "IIOVrt.hpp"
+#include "IIOCodec.hpp"
 
 /***********************************************************************
  * |PothosDoc IIO Source
  *
  * The IIO source forwards an IIO input device to an output sample stream.
  *
+ * Device and channel attributes are read and written with the
+ * deviceAttribute(name), setDeviceAttribute(name, value),
+ * channelAttribute(channel, name) and setChannelAttribute(channel, name,
+ * value) calls. The per-attribute calls "deviceAttribute[name]",
+ * "setdeviceAttribute[name]", "channelAttribute[channel][name]" and
+ * "setChannelAttribute[channel][name]" are registered the first time they
+ * are called. Probes for the getters of the device attributes and of the
+ * attributes of the selected channels are registered when the block is
+ * created, so that they can be connected to before they are first called.
+ *
+ * Large or binary attributes, such as FIR filter configurations, are read
+ * whole with deviceAttributeData(name) and channelAttributeData(channel,
+ * name), and written from a file in one operation with
+ * loadDeviceAttribute(name, path) and loadChannelAttribute(channel, name,
+ * path).
+ *
+ * Attribute writes are checked against the values listed by the
+ * attribute's "_available" companion, if it has one, before reaching the
+ * device: values within a "[min step max]" range are snapped to the step,
+ * and values outside the range or list are rejected. The parsed constraints
+ * are cached, and are returned as JSON by deviceAttributeConstraint(name)
+ * and channelAttributeConstraint(channel, name) for building widgets.
+ *
+ * Device registers are accessed through the driver's debugfs interface with
+ * regRead(address) and regWrite(address, value), or in bulk with
+ * regReadBatch(addresses) and regWriteBatch(addresses, values), which handle
+ * a whole list of registers in one call. Other debug attributes are listed
+ * by debugAttributeNames() and accessed with debugAttribute(name) and
+ * setDebugAttribute(name, value).
+ *
+ * saveProfile(path) captures the writable attributes of the device and its
+ * channels as JSON, which is returned and also written to path unless it is
+ * empty. loadProfile(path) restores a saved profile, skipping attributes
+ * which already hold the saved value and writing the rest in dependency
+ * order, and returns the number of attributes written.
+ *
+ * Instead of polling attribute probes, watchDeviceAttribute(name) and
+ * watchChannelAttribute(channel, name) monitor attributes which may be
+ * changed by the driver or by other processes. Each change is emitted on
+ * the attributeChanged signal with the name of the attribute's getter,
+ * such as "deviceAttribute[name]", and its new value. Changes are queued
+ * by the watcher and emitted from work(), so they are reported while the
+ * block is active; a change which arrives before the last one of the same
+ * attribute was emitted replaces it. Attributes whose drivers support sysfs notification
+ * are waited on, and the rest are read at an interval which backs off
+ * while they are not changing.
+ * unwatchDeviceAttribute(name) and unwatchChannelAttribute(channel, name)
+ * stop watching.
+ *
+ * calibrate() measures streaming throughput across a grid of buffer sizes,
+ * kernel buffer counts and wait strategies, using short bursts on the
+ * block's channels, and returns the measurements and a recommended
+ * configuration as JSON. It can only be called while the block is not
+ * streaming.
+ *
  * |category /IIO
  * |category /Sources
  * |keywords iio industrial io adc sdr
@@ -44,194 +104,586 @@ using json = nlohmann::json;
  * increase latency.
  * |preview disable
  * |default 2048
- * 
+ *
+ * |param outputMode[Output Mode] How samples are forwarded from the IIO device.
+ * <ul>
+ * <li>"STREAM" demultiplexes each enabled scan element to its own output port.</li>
+ * <li>"PACKET" emits each refill as a single Pothos::Packet on the "packet"
+ * output port. The payload holds the interleaved samples exactly as laid out
+ * in the IIO buffer, and the metadata carries the device ID ("deviceId"),
+ * channel layout ("channels", plus "offsets", "sizes" and "step" in
+ * bytes), the index of the first sample ("sampleIndex"), the time of the
+ * first sample in nanoseconds ("timestamp", see below), an overflow flag
+ * ("overflow") which is set when the previous refill was delayed by
+ * downstream backpressure or followed a buffer recovery or idle suspension,
+ * and a discontinuity flag ("discontinuity") which is only set when
+ * samples were lost because the buffer was recreated, matching the
+ * "rxDiscontinuity" label of the other modes.</li>
+ * <li>"COMPLEX" pairs consecutive enabled scan elements as I and Q and
+ * emits normalized complex float samples on a port named after the I
+ * channel with an "_iq" suffix, for example "voltage0_iq". DC offset and I/Q imbalance correction are applied in the same
+ * pass when enabled.</li>
+ * <li>"CHANNELIZER" pairs channels as in "COMPLEX" mode, then splits each
+ * pair into sub-bands with a polyphase filterbank running directly on the
+ * refilled buffer. Each selected sub-band is emitted at 1/numSubbands of
+ * the device sample rate on a port named after the I channel and sub-band
+ * index, for example "voltage0_3".</li>
+ * <li>"SPECTRUM" pairs channels as in "COMPLEX" mode, but instead of time
+ * samples emits averaged power spectra at a low rate. Each spectrum is a
+ * Pothos::Packet on a port named after the I channel with a "_spectrum"
+ * suffix, for example "voltage0_spectrum", holding one float per bin in dBFS with DC in the centre bin. Refills between spectra are
+ * discarded without being converted.</li>
+ * <li>"VRT" creates no output ports, and instead sends each refill as
+ * VITA 49 IF data packets over UDP to the VRT destination, formed directly
+ * from the interleaved buffer. Context packets carrying the sample rate and,
+ * where the first channel has them, the "rf_bandwidth", "frequency" and
+ * "hardwaregain" attributes are sent on activation and once per second.</li>
+ * </ul>
+ * |preview disable
+ * |default "STREAM"
+ * |widget DropDown()
+ * |option [Stream] "STREAM"
+ * |option [Packet] "PACKET"
+ * |option [Complex] "COMPLEX"
+ * |option [Channelizer] "CHANNELIZER"
+ * |option [Spectrum] "SPECTRUM"
+ * |option [VRT] "VRT"
+ * <br>
+ * The output mode is set with setOutputMode(outputMode, numSubbands,
+ * subbands), which sets up the ports of the mode and resets the complex
+ * pair settings below, so it is called before them, and only while the
+ * block is not streaming. The "STREAM" ports are set up when the block is
+ * created, as the ports cannot be removed again. Each mode has port names
+ * of its own, so ports set up for an earlier mode remain, but are unused,
+ * and the "rxTime" and "rxDiscontinuity" labels are only posted on the
+ * ports of the current mode.
+ *
+ * |param numSubbands[Num Sub-bands] The number of sub-bands the channelizer
+ * splits the device bandwidth into. Must be a power of two.
+ * Only applies to the "CHANNELIZER" output mode.
+ * |preview disable
+ * |default 8
+ *
+ * |param subbands[Sub-bands] The indexes of sub-bands to output.
+ * Sub-band k is centred on k/numSubbands of the device sample rate.
+ * If no indexes are specified, all sub-bands will be output.
+ * Only applies to the "CHANNELIZER" output mode.
+ * |preview disable
+ * |default []
+ *
+ * |param channelizerTaps[Channelizer Taps] Prototype lowpass filter taps for
+ * the channelizer, with a cutoff of half the sub-band spacing. If no taps
+ * are specified, a windowed-sinc prototype is designed automatically.
+ * |preview disable
+ * |default []
+ *
+ * |param dcCorrection[DC Correction] Remove DC offset from complex outputs.
+ * Only applies to the "COMPLEX" output mode.
+ * |preview disable
+ * |default False
+ * |widget DropDown()
+ * |option [True] True
+ * |option [False] False
+ *
+ * |param iqCorrection[IQ Correction] Correct I/Q gain and phase imbalance of
+ * complex outputs. Only applies to the "COMPLEX" output mode.
+ * |preview disable
+ * |default False
+ * |widget DropDown()
+ * |option [True] True
+ * |option [False] False
+ *
+ * |param correctionHold[Correction Hold] Freeze the DC and I/Q imbalance
+ * estimates at their current values. Corrections continue to be applied.
+ * |preview disable
+ * |default False
+ * |widget DropDown()
+ * |option [True] True
+ * |option [False] False
+ *
+ * |param correctionRate[Correction Rate] The weight given to each refill
+ * when updating the running DC and I/Q imbalance estimates. Smaller values
+ * track more slowly.
+ * |preview disable
+ * |default 0.01
+ *
+ * |param spectrumSize[Spectrum Size] The number of FFT bins in each spectrum.
+ * Must be a power of two. Only applies to the "SPECTRUM" output mode.
+ * |preview disable
+ * |default 1024
+ *
+ * |param spectrumAverages[Spectrum Averages] The number of FFT frames
+ * averaged into each spectrum. Only applies to the "SPECTRUM" output mode.
+ * |preview disable
+ * |default 16
+ *
+ * |param spectrumRate[Spectrum Rate] The maximum number of spectra to emit
+ * per second. Only applies to the "SPECTRUM" output mode.
+ * |units Hz
+ * |preview disable
+ * |default 4.0
+ *
+ * |param sampleRate[Sample Rate] The nominal sample rate of the device, used
+ * to correlate sample counts with the host clock. If zero, the rate is read
+ * from the device or channel "sampling_frequency" attribute. If a
+ * "timestamp" channel is enabled, its hardware timestamps are used instead.
+ * <br>
+ * The correlated time of the first sample of each refill, in nanoseconds
+ * of CLOCK_REALTIME, is posted as an "rxTime" label on stream ports and
+ * carried as the "timestamp" metadata of packets.
+ * |units Hz
+ * |preview disable
+ * |default 0.0
+ *
+ * |param vrtAddress[VRT Address] The IPv4 address to send VRT packets to,
+ * which may be a multicast group. Only applies to the "VRT" output mode.
+ * |preview disable
+ * |default "127.0.0.1"
+ *
+ * |param vrtPort[VRT Port] The UDP port to send VRT packets to.
+ * |preview disable
+ * |default 4991
+ *
+ * |param vrtStreamId[VRT Stream ID] The stream ID of the VRT packets.
+ * |preview disable
+ * |default 1
+ *
+ * |param vrtPayloadSize[VRT Payload Size] The maximum number of sample bytes
+ * in each VRT data packet. Packets hold a whole number of scans.
+ * |units bytes
+ * |preview disable
+ * |default 1440
+ *
+ * |param recordFile[Record File] If set, every refill is also appended to
+ * this file, in any output mode, for playback with the IIO replay source.
+ * |preview disable
+ * |default ""
+ * |widget FileEntry(mode=save)
+ *
+ * |param recordCompression[Record Compression] Losslessly compress the
+ * recording. Each channel is delta coded and bit-packed per refill, which
+ * suits mostly quiet sensor channels.
+ * |preview disable
+ * |default True
+ * |widget DropDown()
+ * |option [True] True
+ * |option [False] False
+ *
+ * |param recoveryAttempts[Recovery Attempts] When a buffer operation fails
+ * with a transient device error, such as EIO or ETIMEDOUT after a link
+ * reset, the buffer is destroyed and recreated in the block instead of
+ * stopping the topology. The device and the context are not recreated, so
+ * errors which leave them unusable, such as ENODEV once the device has
+ * gone away, still stop it. Attempts back off from 1 ms up to 1 s, and the
+ * error is thrown once this many consecutive attempts have failed. Zero
+ * disables recovery.
+ * |preview disable
+ * |default 8
+ *
+ * |param idleTimeout[Idle Timeout] When downstream blocks have not had room
+ * for a refill for this many seconds, the buffer is destroyed so that the
+ * device stops streaming into it, saving DMA bandwidth and power while the
+ * topology is stalled. The buffer is recreated once there is room again,
+ * and the first refill after it is marked with an "rxDiscontinuity" label
+ * and the packet overflow flag. Zero keeps the buffer enabled.
+ * |units seconds
+ * |preview disable
+ * |default 0.0
+ *
+ * |param bufferHook[Buffer Hook] The name of a buffer hook plugin, which
+ * processes the raw scans of each refill in place before they are
+ * demultiplexed, recorded or sent. Hooks are registered under
+ * /iio/hooks/<name>. Leave empty for no hook.
+ * |preview valid
+ * |default ""
+ *
+ * |param bufferHookArgs[Buffer Hook Args] An arguments string passed to the
+ * buffer hook when it is created.
+ * |preview valid
+ * |default ""
+ *
  * |factory /iio/source(deviceId, channelIds, enablePorts, bufferSize)
+ * |setter setOutputMode(outputMode, numSubbands, subbands)
+ * |setter setChannelizerTaps(channelizerTaps)
+ * |setter setSpectrum(spectrumSize, spectrumAverages, spectrumRate)
+ * |setter setSampleRate(sampleRate)
+ * |setter setVrtDestination(vrtAddress, vrtPort, vrtStreamId)
+ * |setter setVrtPayloadSize(vrtPayloadSize)
+ * |setter setRecording(recordFile, recordCompression)
+ * |setter setBufferHook(bufferHook, bufferHookArgs)
+ * |setter setRecoveryAttempts(recoveryAttempts)
+ * |setter setIdleTimeout(idleTimeout)
+ * |setter setDCCorrection(dcCorrection)
+ * |setter setIQCorrection(iqCorrection)
+ * |setter setCorrectionHold(correctionHold)
+ * |setter setCorrectionRate(correctionRate)
  **********************************************************************/
-class IIOSource : public Pothos::Block
+class IIOSource : public IIOBlock
 {
 private:
-    std::unique_ptr<IIODevice> dev;
-    std::unique_ptr<IIOBuffer> buf;
-    std::vector<IIOChannel> channels;
-    bool enablePorts;
-    size_t bufferSize;
+    enum class OutputMode
+    {
+        Stream,
+        Packet,
+        Complex,
+        Channelizer,
+        Spectrum,
+        Vrt,
+    };
+
+    std::vector<IIOComplexInput> iqPairs;
+    std::set<std::string> portNames;
+    std::vector<Pothos::OutputPort *> modePorts;
+    OutputMode outputMode;
+    size_t numSubbands;
+    std::vector<size_t> subbands;
+    double spectrumRate;
+    long long nextSpectrumNs;
+    double sampleRate;
+    double activeSampleRate;
+    std::unique_ptr<IIOChannel> timestampChannel;
+    IIOClockCorrelator clock;
+    unsigned long long sampleIndex;
+    bool backpressure;
+    IIOVrtSender vrt;
+    std::string vrtAddress;
+    int vrtPort;
+    uint32_t vrtStreamId;
+    long long nextVrtContextNs;
+    std::unique_ptr<IIORecordWriter> recorder;
+    std::string recordFile;
+    bool recordCompression;
+    bool discontinuity;
+    double idleTimeout;
+    long long backpressureStartNs;
+    bool suspended;
+    unsigned long long suspensionCount;
+    size_t scanStep;
+
+    static OutputMode parseOutputMode(const std::string &outputMode)
+    {
+        if (outputMode == "STREAM") return OutputMode::Stream;
+        if (outputMode == "PACKET") return OutputMode::Packet;
+        if (outputMode == "COMPLEX") return OutputMode::Complex;
+        if (outputMode == "CHANNELIZER") return OutputMode::Channelizer;
+        if (outputMode == "SPECTRUM") return OutputMode::Spectrum;
+        if (outputMode == "VRT") return OutputMode::Vrt;
+        throw Pothos::InvalidArgumentException("IIOSource::setOutputMode()", "unknown output mode: " + outputMode);
+    }
+
 public:
     IIOSource(const std::string &deviceId, const std::vector<std::string> &channelIds,
         const bool &enablePorts, const size_t &bufferSize)
-        : enablePorts(enablePorts), bufferSize(bufferSize)
+        : IIOBlock("IIOSource", deviceId, channelIds, enablePorts, bufferSize, false),
+          outputMode(OutputMode::Stream), numSubbands(8),
+          spectrumRate(4.0), nextSpectrumNs(0), sampleRate(0.0), activeSampleRate(0.0), sampleIndex(0), backpressure(false),
+          vrtAddress("127.0.0.1"), vrtPort(4991), vrtStreamId(1), nextVrtContextNs(0), recordCompression(true), discontinuity(false),
+          idleTimeout(0.0), backpressureStartNs(0), suspended(false), suspensionCount(0), scanStep(0)
     {
-        //expose overlay hook
-        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, overlay));
+        //expose output mode and complex output correction controls
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setOutputMode));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setDCCorrection));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setIQCorrection));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setCorrectionHold));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setCorrectionRate));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setChannelizerTaps));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setSpectrum));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setVrtDestination));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setVrtPayloadSize));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, vrtPacketsSent));
+        this->registerProbe("vrtPacketsSent");
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setRecording));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setIdleTimeout));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, suspensions));
+        this->registerProbe("suspensions");
 
-        //get libiio context
-        IIOContext& ctx = IIOContext::get();
+        //expose clock correlation controls
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, setSampleRate));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, measuredSampleRate));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, clockDrift));
+        this->registerProbe("measuredSampleRate");
+        this->registerProbe("clockDrift");
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, dcOffsets));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, iqGainImbalances));
+        this->registerCall(this, POTHOS_FCN_TUPLE(IIOSource, iqPhaseImbalances));
+        this->registerProbe("dcOffsets");
+        this->registerProbe("iqGainImbalances");
+        this->registerProbe("iqPhaseImbalances");
 
-        //if deviceId is blank, create a partial object that exposes the
-        //overlay hook for the gui but cannot be activated
-        if (deviceId == "") {
-            return;
-        }
+        this->setupPorts();
+    }
 
-        //find iio device
-        for (auto d : ctx.devices())
+    void setOutputMode(const std::string &outputMode, const size_t &numSubbands, const std::vector<size_t> &subbands)
+    {
+        if (this->isActive())
         {
-            if (d.id() == deviceId)
-            {
-                this->dev = std::unique_ptr<IIODevice>(new IIODevice(d));
-                break;
-            }
+            throw Pothos::IllegalStateException("IIOSource::setOutputMode()", "cannot change the output mode while streaming");
         }
+        this->outputMode = parseOutputMode(outputMode);
+        this->numSubbands = numSubbands;
+        this->subbands = subbands;
+        this->setupPorts();
+    }
+
+private:
+    void setupPorts(void)
+    {
+        this->modePorts.clear();
         if (!this->dev)
+            return;
+
+        //set up output ports for scannable input channels
+        if (this->enablePorts && this->outputMode == OutputMode::Stream)
         {
-            throw Pothos::SystemException("IIOSource::IIOSource()", "device not found");
+            for (auto c : this->channels)
+            {
+                if (c.isScanElement()) this->setupModeOutput(c.id(), c.dtype());
+            }
         }
 
-        //set up probes/setters for device attributes 
-        for (auto a : this->dev->attributes())
+        //set up a single packet port carrying all scannable input channels
+        if (this->enablePorts && this->outputMode == OutputMode::Packet && this->haveScanElements())
         {
-            Pothos::Callable attrGetter(&IIOSource::getDeviceAttribute);
-            Pothos::Callable attrSetter(&IIOSource::setDeviceAttribute);
-            attrGetter.bind(std::ref(*this), 0);
-            attrGetter.bind(a, 1);
-            attrSetter.bind(std::ref(*this), 0);
-            attrSetter.bind(a, 1);
-
-            std::string getDeviceAttrName = "deviceAttribute[" + a.name() + "]";
-            std::string setDeviceAttrName = "setdeviceAttribute[" + a.name() + "]";
-            this->registerCallable(getDeviceAttrName, attrGetter);
-            this->registerCallable(setDeviceAttrName, attrSetter);
-            this->registerProbe(getDeviceAttrName);
+            this->setupModeOutput("packet", Pothos::DType());
         }
 
-        //set up probes/ports for selected input channels
-        for (auto c : this->dev->channels())
+        //select all sub-bands if none were specified
+        if (this->outputMode == OutputMode::Channelizer)
         {
-            if (c.isOutput())
-                continue;
-            std::string cId = c.id();
-            if (channelIds.size() > 0 && std::none_of(channelIds.begin(), channelIds.end(),
-                    [cId](std::string s){ return s == cId; }))
-                continue;
-            this->channels.push_back(c);
-
-            //set up output ports for scannable input channels
-            if (c.isScanElement() && this->enablePorts)
+            if (this->subbands.empty())
             {
-                this->setupOutput(c.id(), c.dtype());
+                for (size_t k = 0; k < this->numSubbands; k++) this->subbands.push_back(k);
             }
+            for (auto k : this->subbands)
+            {
+                if (k >= this->numSubbands)
+                {
+                    throw Pothos::RangeException("IIOSource::setOutputMode()", "sub-band index out of range: " + std::to_string(k));
+                }
+            }
+        }
 
-            //set up probes/setters for channel attributes
-            for (auto a : c.attributes())
+        //pair up scannable input channels as I/Q and set up complex ports
+        this->iqPairs.clear();
+        if (this->enablePorts && (this->outputMode == OutputMode::Complex ||
+            this->outputMode == OutputMode::Channelizer || this->outputMode == OutputMode::Spectrum))
+        {
+            for (auto pair : iioPairScanElements(this->channels, "IIOSource::setOutputMode()"))
             {
-                Pothos::Callable attrGetter(&IIOSource::getChannelAttribute);
-                Pothos::Callable attrSetter(&IIOSource::setChannelAttribute);
-                attrGetter.bind(std::ref(*this), 0);
-                attrGetter.bind(a, 1);
-                attrSetter.bind(std::ref(*this), 0);
-                attrSetter.bind(a, 1);
-
-                std::string getChannelAttrName = "channelAttribute[" + c.id() + "][" + a.name() + "]";
-                std::string setChannelAttrName = "setChannelAttribute[" + c.id() + "][" + a.name() + "]";
-                this->registerCallable(getChannelAttrName, attrGetter);
-                this->registerCallable(setChannelAttrName, attrSetter);
-                this->registerProbe(getChannelAttrName);
+                this->iqPairs.push_back(IIOComplexInput(pair.first, pair.second));
+                if (this->outputMode == OutputMode::Complex)
+                {
+                    this->setupModeOutput(complexPortName(pair.first), Pothos::DType(typeid(std::complex<float>)));
+                }
+                else if (this->outputMode == OutputMode::Spectrum)
+                {
+                    this->setupModeOutput(spectrumPortName(pair.first), Pothos::DType());
+                }
+                else
+                {
+                    this->iqPairs.back().channelizer = IIOChannelizer(this->numSubbands);
+                    for (auto k : this->subbands)
+                    {
+                        this->setupModeOutput(subbandPortName(pair.first, k), Pothos::DType(typeid(std::complex<float>)));
+                    }
+                }
             }
         }
     }
 
-    std::string overlay(void) const
+    //ports are only set up once, as a mode may be selected again
+    void setupModeOutput(const std::string &name, const Pothos::DType &dtype)
     {
-        IIOContext& ctx = IIOContext::get();
-
-        json topObj;
-        auto &params = topObj["params"];
+        if (this->portNames.insert(name).second) this->setupOutput(name, dtype);
+        this->modePorts.push_back(this->output(name));
+    }
 
-        //configure deviceId dropdown options
-        json deviceIdParam;
-        deviceIdParam["key"] = "deviceId";
-        auto &deviceIdOpts = deviceIdParam["options"];
-        deviceIdParam["widgetKwargs"]["editable"] = false;
-        deviceIdParam["widgetType"] = "DropDown";
+public:
+    static Block *make(const std::string &deviceId, const std::vector<std::string> &channelIds,
+        const bool &enablePorts, const size_t &bufferSize)
+    {
+        return new IIOSource(deviceId, channelIds, enablePorts, bufferSize);
+    }
 
-        //add empty device option associated
-        json emptyOption;
-        emptyOption["name"] = "";
-        emptyOption["value"] = "\"\"";
-        deviceIdOpts.push_back(emptyOption);
+    static std::string complexPortName(IIOChannel c)
+    {
+        return c.id() + "_iq";
+    }
 
-        //enumerate iio devices
-        for (auto d : ctx.devices())
-        {
-            //use the standard label convention, but fall-back on driver/serial
-            std::string name;
+    static std::string subbandPortName(IIOChannel c, size_t subband)
+    {
+        return c.id() + "_" + std::to_string(subband);
+    }
 
-            json option;
-            option["name"] = d.name() + " (" + d.id() + ")";
-            option["value"] = "\"" + d.id() + "\"";
-            deviceIdOpts.push_back(option);
-        }
-        params.push_back(deviceIdParam);
+    static std::string spectrumPortName(IIOChannel c)
+    {
+        return c.id() + "_spectrum";
+    }
 
-        return topObj.dump();
+    void setDCCorrection(const bool enabled)
+    {
+        for (auto &p : this->iqPairs) p.correction.setDCEnabled(enabled);
     }
 
-    static Block *make(const std::string &deviceId, const std::vector<std::string> &channelIds,
-        const bool &enablePorts, const size_t &bufferSize)
+    void setIQCorrection(const bool enabled)
     {
-        return new IIOSource(deviceId, channelIds, enablePorts, bufferSize);
+        for (auto &p : this->iqPairs) p.correction.setIQEnabled(enabled);
     }
 
-    std::string getDeviceAttribute(IIOAttr<IIODevice> a)
+    void setCorrectionHold(const bool hold)
     {
-        return a.value();
+        for (auto &p : this->iqPairs) p.correction.setHold(hold);
     }
 
-    void setDeviceAttribute(IIOAttr<IIODevice> a, Pothos::Object value)
+    void setCorrectionRate(const double rate)
     {
-        a = value.toString();
+        for (auto &p : this->iqPairs) p.correction.setRate(rate);
     }
 
-    std::string getChannelAttribute(IIOAttr<IIOChannel> a)
+    void setChannelizerTaps(const std::vector<float> &taps)
     {
-        return a.value();
+        if (this->outputMode != OutputMode::Channelizer)
+            return;
+        for (auto &p : this->iqPairs) p.channelizer = IIOChannelizer(this->numSubbands, taps);
     }
 
-    void setChannelAttribute(IIOAttr<IIOChannel> a, Pothos::Object value)
+    void setSpectrum(const size_t fftSize, const size_t averages, const double rate)
     {
-        a = value.toString();
+        if (rate <= 0.0)
+        {
+            throw Pothos::RangeException("IIOSource::setSpectrum()", "spectrum rate must be positive");
+        }
+        this->spectrumRate = rate;
+        for (auto &p : this->iqPairs) p.spectrum = IIOSpectrum(fftSize, averages);
     }
 
-    void activate(void)
+    void setVrtDestination(const std::string &address, const int port, const uint32_t streamId)
     {
-        if (!this->dev)
+        this->vrtAddress = address;
+        this->vrtPort = port;
+        this->vrtStreamId = streamId;
+        if (this->vrt.isOpen())
         {
-            throw Pothos::SystemException("IIOSource::activate()", "no device specified");
+            this->vrt.open(this->vrtAddress, this->vrtPort, this->vrtStreamId);
+            this->nextVrtContextNs = 0;
         }
+    }
 
-        bool haveScanElements = false;
-        if (this->buf) {
-            this->buf.reset();
+    void setVrtPayloadSize(const size_t bytes)
+    {
+        this->vrt.setPayloadSize(bytes);
+    }
+
+    unsigned long long vrtPacketsSent(void) const
+    {
+        return this->vrt.packetsSent();
+    }
+
+    void setRecording(const std::string &path, const bool compress)
+    {
+        this->recordFile = path;
+        this->recordCompression = compress;
+        if (this->buf) this->openRecorder();
+    }
+
+    void setIdleTimeout(const double timeout)
+    {
+        if (timeout < 0.0)
+        {
+            throw Pothos::InvalidArgumentException("IIOSource::setIdleTimeout()", "timeout must not be negative");
         }
+        this->idleTimeout = timeout;
+    }
 
+    unsigned long long suspensions(void) const
+    {
+        return this->suspensionCount;
+    }
+
+    void setSampleRate(const double rate)
+    {
+        this->sampleRate = rate;
+    }
+
+    double measuredSampleRate(void) const
+    {
+        return this->clock.measuredSampleRate();
+    }
+
+    double clockDrift(void) const
+    {
+        return this->clock.driftPpm();
+    }
+
+    std::vector<std::complex<double>> dcOffsets(void) const
+    {
+        std::vector<std::complex<double>> offsets;
+        for (auto &p : this->iqPairs) offsets.push_back(p.correction.dcOffset());
+        return offsets;
+    }
+
+    std::vector<double> iqGainImbalances(void) const
+    {
+        std::vector<double> gains;
+        for (auto &p : this->iqPairs) gains.push_back(p.correction.gainImbalance());
+        return gains;
+    }
+
+    std::vector<double> iqPhaseImbalances(void) const
+    {
+        std::vector<double> phases;
+        for (auto &p : this->iqPairs) phases.push_back(p.correction.phaseImbalance());
+        return phases;
+    }
+
+    void activate(void)
+    {
+        this->createBuffer();
+        if (this->buf) this->scanStep = this->buf->step();
+
+        this->sampleIndex = 0;
+        this->backpressure = false;
+        this->discontinuity = false;
+        this->suspended = false;
+        this->backpressureStartNs = 0;
+        this->recovery.reset();
+        this->nextSpectrumNs = 0;
+        this->clock.reset();
+        this->activeSampleRate = this->nominalSampleRate();
+        this->timestampChannel.reset();
         for (auto c : this->channels)
         {
-            c.enable();
-
-            if (c.isScanElement())
+            if (c.isScanElement() && c.id() == "timestamp")
             {
-                haveScanElements = true;
+                this->timestampChannel.reset(new IIOChannel(c));
             }
         }
+        for (auto &p : this->iqPairs)
+        {
+            if (this->outputMode == OutputMode::Channelizer) p.channelizer.reset();
+            if (this->outputMode == OutputMode::Spectrum) p.spectrum.reset();
+        }
 
-        //create sample buffer if we've got any scan elements
-        if (haveScanElements && this->enablePorts) {
-            this->buf = std::unique_ptr<IIOBuffer>(new IIOBuffer(std::move(this->dev->createBuffer(this->bufferSize, false))));
-            if (!this->buf)
+        //describe the scan layout so VRT payloads can be formed in place
+        if (this->outputMode == OutputMode::Vrt && this->buf)
+        {
+            std::vector<IIOVrtField> fields;
+            for (auto c : this->channels)
             {
-                throw Pothos::SystemException("IIOSource::activate()", "buffer creation failed");
+                if (!c.isScanElement())
+                    continue;
+                IIOVrtField f;
+                f.offset = static_cast<char*>(this->buf->first(c)) - static_cast<char*>(this->buf->start());
+                f.size = c.format().length / 8;
+                f.bigEndian = c.format().is_be;
+                fields.push_back(f);
             }
-            this->buf->setBlockingMode(false);
+            this->vrt.open(this->vrtAddress, this->vrtPort, this->vrtStreamId);
+            this->vrt.setLayout(fields, this->buf->step());
+            this->nextVrtContextNs = 0;
         }
+
+        if (this->buf) this->openRecorder();
     }
 
     void deactivate(void)
@@ -239,14 +691,36 @@ public:
         if (this->buf) {
             this->buf.reset();
         }
+        this->suspended = false;
+        this->vrt.close();
+        this->recorder.reset();
     }
 
     void work(void)
     {
+        this->emitAttributeChanges();
+        if (this->recovery.active())
+        {
+            if (!this->recoverBuffer())
+                return;
+
+            //samples were lost, so restart clock correlation and flag the gap
+            this->clock.reset();
+            this->discontinuity = true;
+            this->backpressure = true;
+        }
+        if (this->suspended && !this->resumeBuffer())
+            return;
+
         if (this->buf) {
             //verify we have enough space in our output buffers to refill
-            if (this->workInfo().minOutElements < this->bufferSize)
+            if (!this->haveOutputSpace())
+            {
+                if (this->backpressureStartNs == 0) this->backpressureStartNs = IIOClockCorrelator::now();
+                this->backpressure = true;
+                if (this->idleTimeout > 0.0) this->idleWait();
                 return;
+            }
 
             //wait for samples
             struct pollfd pfd = {
@@ -265,22 +739,285 @@ public:
                 return this->yield();
 
             //get new samples from iio device
-            auto bytes_read = this->buf->refill();
+            const long long refillStartNs = IIOClockCorrelator::now();
+            size_t bytes_read;
+            try
+            {
+                bytes_read = this->buf->refill();
+            }
+            catch (const Pothos::SystemException &ex)
+            {
+                if (!this->recovery.begin(ex, IIOClockCorrelator::now()))
+                    throw;
+                this->buf.reset();
+                return this->yield();
+            }
+            const long long refillEndNs = IIOClockCorrelator::now();
             //libiio read operations shouldn't return partial scans
             assert(bytes_read % this->buf->step() == 0);
             auto sample_count = bytes_read / this->buf->step();
 
-            //generate samples
-            for (auto c : this->channels)
+            //label the first sample of the refill with its correlated time
+            const long long timeNs = iioCorrelateRefill(this->clock, *this->buf, this->timestampChannel.get(),
+                this->activeSampleRate, this->sampleIndex, sample_count, refillStartNs, refillEndNs);
+            this->runHook(sample_count, this->sampleIndex, timeNs);
+            if (this->recorder)
+            {
+                this->recorder->write(this->buf->start(), sample_count, this->sampleIndex, timeNs);
+            }
+            if (this->outputMode != OutputMode::Packet && this->outputMode != OutputMode::Spectrum &&
+                this->outputMode != OutputMode::Vrt)
             {
-                if (c.isScanElement()) {
-                    auto outputPort = this->output(c.id());
-                    auto outputBuffer = outputPort->buffer();
+                for (auto outputPort : this->modePorts)
+                {
+                    outputPort->postLabel(Pothos::Label("rxTime", timeNs, 0));
+                    if (this->discontinuity)
+                    {
+                        outputPort->postLabel(Pothos::Label("rxDiscontinuity", this->sampleIndex, 0));
+                    }
+                }
+            }
 
-                    c.read(*this->buf, outputBuffer.as<void*>(), sample_count);
+            //generate samples
+            if (this->outputMode == OutputMode::Packet)
+            {
+                this->producePacket(bytes_read, sample_count, timeNs);
+            }
+            else if (this->outputMode == OutputMode::Complex)
+            {
+                for (auto &p : this->iqPairs)
+                {
+                    auto outputPort = this->output(complexPortName(p.i));
+                    p.convert(*this->buf, outputPort->buffer().as<std::complex<float>*>(), sample_count);
                     outputPort->produce(sample_count);
                 }
             }
+            else if (this->outputMode == OutputMode::Channelizer)
+            {
+                for (auto &p : this->iqPairs)
+                {
+                    std::vector<std::complex<float>*> outputs;
+                    for (auto k : this->subbands)
+                    {
+                        outputs.push_back(this->output(subbandPortName(p.i, k))->buffer().as<std::complex<float>*>());
+                    }
+                    auto produced = p.channelize(*this->buf, sample_count, this->subbands, outputs.data());
+                    for (auto k : this->subbands)
+                    {
+                        this->output(subbandPortName(p.i, k))->produce(produced);
+                    }
+                }
+            }
+            else if (this->outputMode == OutputMode::Spectrum)
+            {
+                this->produceSpectrum(sample_count, timeNs);
+            }
+            else if (this->outputMode == OutputMode::Vrt)
+            {
+                this->sendVrt(sample_count, timeNs);
+            }
+            else
+            {
+                for (auto c : this->channels)
+                {
+                    if (c.isScanElement()) {
+                        auto outputPort = this->output(c.id());
+                        auto outputBuffer = outputPort->buffer();
+
+                        c.read(*this->buf, outputBuffer.as<void*>(), sample_count);
+                        outputPort->produce(sample_count);
+                    }
+                }
+            }
+
+            this->sampleIndex += sample_count;
+            this->backpressure = false;
+            this->backpressureStartNs = 0;
+            this->discontinuity = false;
+        }
+    }
+
+private:
+    double calibrationSampleRate(void)
+    {
+        return this->nominalSampleRate();
+    }
+
+    double nominalSampleRate(void)
+    {
+        if (this->sampleRate > 0.0)
+            return this->sampleRate;
+
+        //fall back on the sampling_frequency attribute of the device or the
+        //first channel that has one
+        try
+        {
+            return std::stod(this->dev->attributes().at("sampling_frequency").value());
+        }
+        catch (const std::exception &) {}
+        for (auto c : this->channels)
+        {
+            try
+            {
+                return std::stod(c.attributes().at("sampling_frequency").value());
+            }
+            catch (const std::exception &) {}
+        }
+        return 0.0;
+    }
+
+    bool haveOutputSpace(void)
+    {
+        if (this->outputMode == OutputMode::Packet)
+        {
+            return this->output("packet")->buffer().length >= this->bufferSize * this->scanStep;
+        }
+        if (this->outputMode == OutputMode::Spectrum || this->outputMode == OutputMode::Vrt)
+        {
+            return true;
+        }
+        if (this->outputMode == OutputMode::Channelizer && !this->iqPairs.empty())
+        {
+            return this->minOutputSpace() >= this->iqPairs.front().channelizer.maxOutputs(this->bufferSize);
+        }
+        return this->minOutputSpace() >= this->bufferSize;
+    }
+
+    //the space on the ports of the current mode, ignoring any ports left
+    //over from an earlier mode
+    size_t minOutputSpace(void)
+    {
+        size_t space = this->modePorts.empty() ? 0 : ~size_t(0);
+        for (auto outputPort : this->modePorts)
+        {
+            space = std::min(space, outputPort->elements());
+        }
+        return space;
+    }
+
+    void producePacket(size_t bytes, size_t sample_count, long long timeNs)
+    {
+        auto outputPort = this->output("packet");
+
+        //copy the interleaved refill into the pooled output buffer, which is
+        //then popped off the port and handed downstream as the payload
+        Pothos::Packet packet;
+        packet.payload = outputPort->buffer();
+        packet.payload.length = bytes;
+        std::memcpy(packet.payload.as<void*>(), this->buf->start(), bytes);
+        outputPort->popBuffer(bytes);
+
+        packet.metadata["deviceId"] = Pothos::Object(this->dev->id());
+        iioPacketLayout(*this->buf, this->channels, packet.metadata);
+        packet.metadata["sampleIndex"] = Pothos::Object(this->sampleIndex);
+        packet.metadata["sampleCount"] = Pothos::Object(sample_count);
+        packet.metadata["timestamp"] = Pothos::Object(timeNs);
+        packet.metadata["overflow"] = Pothos::Object(this->backpressure);
+        packet.metadata["discontinuity"] = Pothos::Object(this->discontinuity);
+
+        outputPort->postMessage(packet);
+    }
+
+    void openRecorder(void)
+    {
+        this->recorder.reset();
+        if (this->recordFile.empty())
+            return;
+
+        this->recorder.reset(new IIORecordWriter(this->recordFile, iioScanLayout(*this->buf, this->channels),
+            this->buf->step(), this->activeSampleRate, this->recordCompression));
+    }
+
+    /*!
+     * Suspend the buffer once backpressure has lasted for the idle timeout.
+     * Without room downstream the scheduler has no reason to call work()
+     * again, so until the deadline each call waits for a slice of at most
+     * the work timeout and yields to check it again.
+     */
+    void idleWait(void)
+    {
+        const long long deadlineNs = this->backpressureStartNs + static_cast<long long>(this->idleTimeout * 1e9);
+        if (IIOClockCorrelator::now() < deadlineNs)
+        {
+            this->waitUntil(deadlineNs);
+            return;
+        }
+
+        //destroying the buffer disables it, which stops the device streaming
+        this->buf.reset();
+        this->suspended = true;
+        this->suspensionCount++;
+    }
+
+    bool resumeBuffer(void)
+    {
+        if (!this->haveOutputSpace())
+            return false;
+
+        try
+        {
+            this->buf.reset(new IIOBuffer(std::move(this->dev->createBuffer(this->bufferSize, false))));
+            this->buf->setBlockingMode(false);
+        }
+        catch (const Pothos::SystemException &ex)
+        {
+            this->suspended = false;
+            if (!this->recovery.begin(ex, IIOClockCorrelator::now()))
+                throw;
+            this->buf.reset();
+            this->yield();
+            return false;
+        }
+
+        //the device was idle, so restart clock correlation and flag the gap
+        this->suspended = false;
+        this->clock.reset();
+        this->discontinuity = true;
+        this->backpressure = true;
+        return true;
+    }
+
+    void sendVrt(size_t sample_count, long long timeNs)
+    {
+        //refresh the stream context once per second
+        const long long now = IIOClockCorrelator::now();
+        if (now >= this->nextVrtContextNs)
+        {
+            this->vrt.sendContext(iioVrtContext(this->channels, this->activeSampleRate), timeNs);
+            this->nextVrtContextNs = now + 1000000000;
+        }
+
+        const double rate = this->clock.locked() ? this->clock.measuredSampleRate() : this->activeSampleRate;
+        this->vrt.sendData(this->buf->start(), sample_count, timeNs, rate);
+    }
+
+    void produceSpectrum(size_t sample_count, long long timeNs)
+    {
+        //between spectra, refills are only drained from the device
+        const long long now = IIOClockCorrelator::now();
+        if (now < this->nextSpectrumNs)
+            return;
+
+        bool emitted = false;
+        for (auto &p : this->iqPairs)
+        {
+            if (!p.accumulate(*this->buf, sample_count))
+                continue;
+
+            const auto psd = p.spectrum.psd();
+            Pothos::Packet packet;
+            packet.payload = Pothos::BufferChunk(Pothos::DType(typeid(float)), psd.size());
+            std::copy(psd.begin(), psd.end(), packet.payload.as<float*>());
+            packet.metadata["sampleIndex"] = Pothos::Object(this->sampleIndex);
+            packet.metadata["timestamp"] = Pothos::Object(timeNs);
+            this->output(spectrumPortName(p.i))->postMessage(packet);
+            p.spectrum.reset();
+            emitted = true;
+        }
+
+        if (emitted)
+        {
+            this->nextSpectrumNs = now + static_cast<long long>(1e9 / this->spectrumRate);
         }
     }
 };
@@ -0,0 +1,128 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "IIOFFT.hpp"
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+/*!
+ * IIOSpectrum computes an averaged power spectral density from a complex
+ * stream using non-overlapping Blackman-Harris windowed FFT frames.
+ *
+ * Samples are fed in with process() until the requested number of frames has
+ * been averaged, at which point psd() returns the spectrum in dBFS with DC in
+ * the centre bin.
+ */
+class IIOSpectrum
+{
+private:
+    size_t averages;
+    size_t frames;
+    IIOFFT fft;
+    std::vector<float> window;
+    float windowPower;
+    std::vector<std::complex<float>> frame;
+    size_t frameFill;
+    std::vector<double> power;
+
+public:
+    IIOSpectrum(size_t fftSize = 1024, size_t averages = 16) :
+        averages(std::max<size_t>(averages, 1)), frames(0), fft(fftSize),
+        window(fftSize), frame(fftSize), frameFill(0), power(fftSize)
+    {
+        const double pi = std::acos(-1.0);
+        double sum = 0.0;
+        for (size_t i = 0; i < fftSize; i++)
+        {
+            const double x = 2.0 * pi * i / fftSize;
+            this->window[i] = static_cast<float>(0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x));
+            sum += this->window[i];
+        }
+        this->windowPower = static_cast<float>(sum * sum);
+    }
+
+    /*!
+     * Get the number of bins in each spectrum.
+     */
+    size_t size(void) const
+    {
+        return this->fft.size();
+    }
+
+    /*!
+     * Discard any partially accumulated spectrum.
+     */
+    void reset(void)
+    {
+        this->frames = 0;
+        this->frameFill = 0;
+        std::fill(this->power.begin(), this->power.end(), 0.0);
+    }
+
+    /*!
+     * Check whether enough frames have been averaged to read the spectrum.
+     */
+    bool ready(void) const
+    {
+        return this->frames >= this->averages;
+    }
+
+    /*!
+     * Get the number of samples still needed before the spectrum is ready.
+     */
+    size_t remaining(void) const
+    {
+        if (this->ready()) return 0;
+        return (this->averages - this->frames) * this->fft.size() - this->frameFill;
+    }
+
+    /*!
+     * Accumulate up to count samples, stopping once the spectrum is ready.
+     * Returns the number of samples used.
+     */
+    size_t process(const std::complex<float> *input, size_t count)
+    {
+        const size_t n = this->fft.size();
+        size_t used = 0;
+        while (used < count && !this->ready())
+        {
+            const size_t take = std::min(count - used, n - this->frameFill);
+            for (size_t i = 0; i < take; i++)
+            {
+                this->frame[this->frameFill + i] = input[used + i] * this->window[this->frameFill + i];
+            }
+            used += take;
+            this->frameFill += take;
+            if (this->frameFill < n)
+                break;
+
+            this->fft.transform(this->frame.data());
+            for (size_t i = 0; i < n; i++)
+            {
+                this->power[i] += std::norm(this->frame[i]);
+            }
+            this->frameFill = 0;
+            this->frames++;
+        }
+        return used;
+    }
+
+    /*!
+     * Get the averaged spectrum in dBFS, with DC in the centre bin.
+     */
+    std::vector<float> psd(void) const
+    {
+        const size_t n = this->fft.size();
+        const double scale = 1.0 / (std::max<size_t>(this->frames, 1) * this->windowPower);
+        std::vector<float> out(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const double p = this->power[(i + n / 2) % n] * scale;
+            out[i] = static_cast<float>(10.0 * std::log10(std::max(p, 1e-20)));
+        }
+        return out;
+    }
+};
@@ -4,23 +4,355 @@
 #include "IIOSupport.hpp"
 #include <Pothos/Framework.hpp>
 #include <Poco/Error.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//attribute prefetch defaults according to whether the context is remote
+static const unsigned int AUTO_PREFETCH = ~0u;
+
+//writes which change the available values of other attributes of the same
+//device or channel; a dependent of "*" stands for every device and channel
+static const struct
+{
+    const char *attr;
+    const char *dependent;
+} constraintDependents[] = {
+    {"sampling_frequency", "rf_bandwidth"},
+    {"oversampling_ratio", "sampling_frequency"},
+    {"filter_fir_en", "sampling_frequency"},
+    {"gain_control_mode", "hardwaregain"},
+    {"frequency", "*"},
+    {"filter_fir_config", "*"},
+    {"trx_rate_governor", "*"},
+};
+
+static long long steadyNowMs(void)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 IIOContextRaw::IIOContextRaw(void)
+    : raw_ptr(nullptr), live_ptr(nullptr), prefetchMs(AUTO_PREFETCH),
+    pipelineDepth(0), isRemote(false)
 {
-    this->raw_ptr = iio_create_local_context();
-    if (!this->raw_ptr)
+    const char *prefetchMs = std::getenv("POTHOS_IIO_ATTR_PREFETCH_MS");
+    if (prefetchMs) this->prefetchMs = std::strtoul(prefetchMs, nullptr, 10);
+    const char *pipelineDepth = std::getenv("POTHOS_IIO_PIPELINE_DEPTH");
+    if (pipelineDepth) this->pipelineDepth = std::strtoul(pipelineDepth, nullptr, 10);
+
+    const char *cachePath = std::getenv("POTHOS_IIO_CONTEXT_CACHE");
+    if (cachePath) this->cachePath = cachePath;
+
+    //build the topology from the snapshot if there is a usable one
+    if (!this->cachePath.empty() && std::ifstream(this->cachePath).good())
+    {
+        this->raw_ptr = iio_create_xml_context(this->cachePath.c_str());
+        if (this->raw_ptr)
+            return;
+    }
+
+    this->raw_ptr = create();
+    this->live_ptr = this->raw_ptr;
+    this->isRemote = std::strcmp(iio_context_get_name(this->raw_ptr), "local") != 0;
+    if (!this->cachePath.empty())
     {
-        throw Pothos::SystemException("IIOContextRaw::IIOContextRaw()", "iio_create_local_context: " + Poco::Error::getMessage(Poco::Error::last()));
+        writeCache(this->cachePath, this->raw_ptr);
     }
 }
 
 IIOContextRaw::~IIOContextRaw(void)
 {
+    struct iio_context *live = this->live_ptr.load();
+    if (live && live != this->raw_ptr)
+    {
+        iio_context_destroy(live);
+    }
     iio_context_destroy(this->raw_ptr);
 }
 
+void IIOContextRaw::writeCache(const std::string &path, const struct iio_context *ctx)
+{
+    //write to a temporary file and rename it into place, so that concurrent
+    //processes never read a partial snapshot; failures only cost the cache
+    const char *xml = iio_context_get_xml(ctx);
+    if (!xml)
+        return;
+    const std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        out << xml;
+        if (!out)
+        {
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmpPath.c_str());
+    }
+}
+
+struct iio_context *IIOContextRaw::create(void)
+{
+    const char *uri = std::getenv("POTHOS_IIO_CONTEXT_URI");
+    struct iio_context *ctx = uri ? iio_create_context_from_uri(uri) : iio_create_local_context();
+    if (!ctx)
+    {
+        throw Pothos::SystemException("IIOContextRaw::create()", std::string(uri ? "iio_create_context_from_uri: " : "iio_create_local_context: ") + Poco::Error::getMessage(Poco::Error::last()));
+    }
+
+    const char *timeout = std::getenv("POTHOS_IIO_CONTEXT_TIMEOUT");
+    if (timeout)
+    {
+        int ret = iio_context_set_timeout(ctx, std::strtoul(timeout, nullptr, 10));
+        if (ret)
+        {
+            iio_context_destroy(ctx);
+            throw Pothos::SystemException("IIOContextRaw::create()", "iio_context_set_timeout: " + Poco::Error::getMessage(-ret));
+        }
+    }
+    return ctx;
+}
+
+struct iio_context *IIOContextRaw::live(void)
+{
+    struct iio_context *ctx = this->live_ptr.load();
+    if (ctx)
+        return ctx;
+
+    ctx = create();
+    this->isRemote = std::strcmp(iio_context_get_name(ctx), "local") != 0;
+
+    //refresh a stale snapshot for the next process
+    std::ifstream in(this->cachePath);
+    std::stringstream cached;
+    cached << in.rdbuf();
+    const char *xml = iio_context_get_xml(ctx);
+    if (xml && cached.str() != xml)
+    {
+        writeCache(this->cachePath, ctx);
+    }
+
+    //published last, for the unlocked checks in live(device) and live(channel)
+    this->live_ptr.store(ctx);
+    return ctx;
+}
+
+bool IIOContextRaw::findConstraint(const void *parent, const char *attr, IIOAttrConstraint &constraint)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto p = this->constraints.find(parent);
+    if (p == this->constraints.end())
+        return false;
+    auto it = p->second.find(attr);
+    if (it == p->second.end())
+        return false;
+    constraint = it->second;
+    return true;
+}
+
+void IIOContextRaw::storeConstraint(const void *parent, const char *attr, const IIOAttrConstraint &constraint)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->constraints[parent][attr] = constraint;
+}
+
+bool IIOContextRaw::hasSnapshot(const void *parent)
+{
+    const unsigned int ttl = this->attributePrefetch();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto p = this->snapshots.find(parent);
+    if (p == this->snapshots.end())
+        return false;
+    if (steadyNowMs() - p->second.first >= ttl)
+    {
+        this->snapshots.erase(p);
+        return false;
+    }
+    return true;
+}
+
+bool IIOContextRaw::findSnapshot(const void *parent, const char *attr, std::string &value)
+{
+    if (!this->hasSnapshot(parent))
+        return false;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto p = this->snapshots.find(parent);
+    if (p == this->snapshots.end())
+        return false;
+    auto it = p->second.second.find(attr);
+    if (it == p->second.second.end())
+        return false;
+    value = it->second;
+    return true;
+}
+
+void IIOContextRaw::storeSnapshot(const void *parent, const std::vector<std::pair<std::string, std::string>> &values)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto &snapshot = this->snapshots[parent];
+    snapshot.first = steadyNowMs();
+    snapshot.second = std::map<std::string, std::string>(values.begin(), values.end());
+}
+
+void IIOContextRaw::invalidate(const void *parent, const char *attr)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->snapshots.erase(parent);
+
+    std::vector<const char *> dependents(1, attr);
+    for (const auto &dep : constraintDependents)
+    {
+        if (std::strcmp(dep.attr, attr) != 0)
+            continue;
+        if (std::strcmp(dep.dependent, "*") == 0)
+        {
+            this->snapshots.clear();
+            this->constraints.clear();
+            return;
+        }
+        dependents.push_back(dep.dependent);
+    }
+
+    auto p = this->constraints.find(parent);
+    if (p == this->constraints.end())
+        return;
+    for (auto it = p->second.begin(); it != p->second.end();)
+    {
+        const bool stale = std::any_of(dependents.begin(), dependents.end(),
+            [&it](const char *name) { return std::strcmp(it->first, name) == 0; });
+        if (stale) it = p->second.erase(it);
+        else ++it;
+    }
+}
+
+bool IIOContextRaw::hasDependents(const char *attr, bool &everywhere)
+{
+    bool found = false;
+    everywhere = false;
+    for (const auto &dep : constraintDependents)
+    {
+        if (std::strcmp(dep.attr, attr) != 0)
+            continue;
+        found = true;
+        if (std::strcmp(dep.dependent, "*") == 0) everywhere = true;
+    }
+    return found;
+}
+
+bool IIOContextRaw::remote(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->live();
+    return this->isRemote;
+}
+
+unsigned int IIOContextRaw::attributePrefetch(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->prefetchMs != AUTO_PREFETCH)
+        return this->prefetchMs;
+    this->live();
+    return this->isRemote ? 250 : 0;
+}
+
+void IIOContextRaw::setAttributePrefetch(unsigned int ms)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->prefetchMs = ms;
+    if (ms == 0) this->snapshots.clear();
+}
+
+size_t IIOContextRaw::bufferPipelineDepth(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->pipelineDepth;
+}
+
+void IIOContextRaw::setBufferPipelineDepth(size_t depth)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->pipelineDepth = depth;
+}
+
+void IIOContextRaw::setTimeout(unsigned int ms)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    int ret = iio_context_set_timeout(this->live(), ms);
+    if (ret)
+    {
+        throw Pothos::SystemException("IIOContextRaw::setTimeout()", "iio_context_set_timeout: " + Poco::Error::getMessage(-ret));
+    }
+}
+
+bool IIOContextRaw::cached(void) const
+{
+    return this->live_ptr.load() != this->raw_ptr;
+}
+
+const struct iio_device *IIOContextRaw::live(const struct iio_device *device)
+{
+    if (!device || this->live_ptr.load() == this->raw_ptr)
+        return device;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto ctx = this->live();
+    if (iio_device_get_context(device) == ctx)
+        return device;
+
+    auto it = this->liveDevices.find(device);
+    if (it != this->liveDevices.end())
+        return it->second;
+
+    const char *id = iio_device_get_id(device);
+    const struct iio_device *liveDevice = iio_context_find_device(ctx, id);
+    if (!liveDevice)
+    {
+        throw Pothos::NotFoundException("IIOContextRaw::live()", "device no longer present: " + std::string(id));
+    }
+    this->liveDevices[device] = liveDevice;
+    return liveDevice;
+}
+
+struct iio_channel *IIOContextRaw::live(const struct iio_channel *channel)
+{
+    if (this->live_ptr.load() == this->raw_ptr)
+        return const_cast<struct iio_channel *>(channel);
+
+    const struct iio_device *liveDevice = this->live(iio_channel_get_device(channel));
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (iio_channel_get_device(channel) == liveDevice)
+        return const_cast<struct iio_channel *>(channel);
+
+    auto it = this->liveChannels.find(channel);
+    if (it != this->liveChannels.end())
+        return it->second;
+
+    const char *id = iio_channel_get_id(channel);
+    struct iio_channel *liveChannel = iio_device_find_channel(liveDevice, id, iio_channel_is_output(channel));
+    if (!liveChannel)
+    {
+        throw Pothos::NotFoundException("IIOContextRaw::live()", "channel no longer present: " + std::string(id));
+    }
+    this->liveChannels[channel] = liveChannel;
+    return liveChannel;
+}
+
 IIOContext::IIOContext(void) : ctx(new IIOContextRaw()) {}
 
 IIOContext& IIOContext::get()
@@ -53,6 +385,31 @@ std::string IIOContext::description(void)
     return std::string(iio_context_get_description(this->ctx->raw_ptr));
 }
 
+bool IIOContext::cached(void)
+{
+    return this->ctx->cached();
+}
+
+bool IIOContext::remote(void)
+{
+    return this->ctx->remote();
+}
+
+void IIOContext::setTimeout(unsigned int ms)
+{
+    this->ctx->setTimeout(ms);
+}
+
+void IIOContext::setAttributePrefetch(unsigned int ms)
+{
+    this->ctx->setAttributePrefetch(ms);
+}
+
+void IIOContext::setBufferPipelineDepth(size_t depth)
+{
+    this->ctx->setBufferPipelineDepth(depth);
+}
+
 std::vector<IIODevice> IIOContext::devices(void)
 {
     auto device_count = iio_context_get_devices_count(this->ctx->raw_ptr);
@@ -96,13 +453,12 @@ typename IIOAttrs<T>::Iterator IIOAttrs<T>::end()
 template <class T>
 IIOAttr<T> IIOAttrs<T>::at(const std::string& name)
 {
-    for (auto a : *this)
+    const char *attr = this->parent.iio_find_attr(name.c_str());
+    if (!attr)
     {
-        if (a.name() == name) {
-            return a;
-        }
+        throw Pothos::RangeException("IIOAttr<T>::at()", "attribute not found: " + name);
     }
-    throw Pothos::RangeException("IIOAttr<T>::at()", "attribute not found");
+    return IIOAttr<T>(this->parent, attr);
 }
 
 template <class T>
@@ -117,6 +473,52 @@ bool IIOAttrs<T>::empty() const
     return this->size() == 0;
 }
 
+template <class T>
+std::vector<std::pair<std::string, std::string>> IIOAttrs<T>::values()
+{
+    std::vector<std::pair<std::string, std::string>> values;
+    if (this->parent.iio_attr_read_all(values) >= 0)
+    {
+        if (this->parent.handle())
+        {
+            this->parent.context().storeSnapshot(this->parent.handle(), values);
+        }
+        return values;
+    }
+
+    //fall back on reading attributes one at a time
+    values.clear();
+    for (auto a : *this)
+    {
+        try
+        {
+            values.push_back(std::make_pair(a.name(), a.value()));
+        }
+        catch (const Pothos::Exception &) {}
+    }
+    return values;
+}
+
+template <class T>
+void IIOAttrs<T>::prefetch()
+{
+    if (!this->parent.handle() || this->parent.context().attributePrefetch() == 0)
+        return;
+    std::vector<std::pair<std::string, std::string>> values;
+    if (this->parent.iio_attr_read_all(values) < 0)
+        values.clear();
+    this->parent.context().storeSnapshot(this->parent.handle(), values);
+}
+
+//collects the results of iio_*_attr_read_all()
+template <class P>
+static int collectAttr(P *, const char *attr, const char *value, size_t len, void *d)
+{
+    auto values = static_cast<std::vector<std::pair<std::string, std::string>> *>(d);
+    values->push_back(std::make_pair(std::string(attr), std::string(value, strnlen(value, len))));
+    return 0;
+}
+
 template <class T>
 IIOAttr<T>::IIOAttr(T parent, const char* attr)
     : parent(parent), attr(attr) {}
@@ -133,10 +535,58 @@ std::string IIOAttr<T>::value()
     return std::string(*this);
 }
 
+template <class T>
+std::string IIOAttr<T>::path() const
+{
+    return this->parent.iio_attr_path(this->attr);
+}
+
+template <class T>
+bool IIOAttr<T>::writable()
+{
+    //the sysfs path is on the remote machine, not this one
+    if (this->parent.context().remote())
+        return true;
+    struct stat st;
+    const std::string path = this->path();
+    if (path.empty() || stat(path.c_str(), &st) != 0)
+        return true;
+    return (st.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) != 0;
+}
+
+template <class T>
+IIOAttrConstraint IIOAttr<T>::constraint()
+{
+    IIOAttrConstraint constraint;
+    const void *handle = this->parent.handle();
+    if (!handle)
+        return constraint;
+    auto &ctx = this->parent.context();
+    if (ctx.findConstraint(handle, this->attr, constraint))
+        return constraint;
+
+    const char *available = this->parent.iio_find_attr((std::string(this->attr) + "_available").c_str());
+    if (available)
+    {
+        try
+        {
+            constraint = IIOAttrConstraint::parse(IIOAttr<T>(this->parent, available).value());
+        }
+        catch (const Pothos::Exception &) {}
+    }
+    ctx.storeConstraint(handle, this->attr, constraint);
+    return constraint;
+}
+
 template <class T>
 IIOAttr<T>& IIOAttr<T>::operator=(const std::string& other)
 {
-    ssize_t ret = this->parent.iio_attr_write(this->attr, other.c_str());
+    const std::string value = this->constraint().check(this->name(), other);
+    ssize_t ret = this->parent.iio_attr_write(this->attr, value.c_str());
+    if (this->parent.handle())
+    {
+        this->parent.context().invalidate(this->parent.handle(), this->attr);
+    }
     if (ret < 0)
     {
         throw Pothos::SystemException("IIOAttr<T>::operator=()", "iio_attr_write: " + Poco::Error::getMessage(-ret));
@@ -145,25 +595,99 @@ IIOAttr<T>& IIOAttr<T>::operator=(const std::string& other)
 }
 
 template <class T>
-IIOAttr<T>::operator std::string() const
+ssize_t IIOAttr<T>::readInto(std::vector<char> &buf) const
 {
-    // Note: we use a fixed buffer for this operation because libiio doesn't
-    // provide a way to determine the attribute's length.
-    char buf[1024];
-    ssize_t ret = this->parent.iio_attr_read(this->attr, buf, sizeof(buf));
+    // Note: libiio doesn't provide a way to determine the attribute's length,
+    // so a read which fills the buffer is retried with a larger one.
+    static const size_t maxSize = 64 << 20;
+    buf.resize(1024);
+    while (true)
+    {
+        ssize_t ret = this->parent.iio_attr_read(this->attr, buf.data(), buf.size());
+        if (ret < 0)
+        {
+            throw Pothos::SystemException("IIOAttr<T>::read()", "iio_attr_read: " + Poco::Error::getMessage(-ret));
+        }
+        if (static_cast<size_t>(ret) < buf.size())
+            return ret;
+        if (buf.size() >= maxSize)
+        {
+            throw Pothos::RangeException("IIOAttr<T>::read()", "attribute too large: " + std::string(this->attr));
+        }
+        buf.resize(buf.size() * 4);
+    }
+}
+
+template <class T>
+std::string IIOAttr<T>::data() const
+{
+    std::vector<char> buf;
+    ssize_t ret = this->readInto(buf);
 
+    //drop the terminator libiio appends to what was read
+    if (ret > 0 && buf[ret - 1] == '\0') ret--;
+    return std::string(buf.data(), ret);
+}
+
+template <class T>
+void IIOAttr<T>::write(const void *src, size_t length)
+{
+    //libiio hands the whole blob to a single sysfs write or iiod command
+    ssize_t ret = this->parent.iio_attr_write_raw(this->attr, src, length);
+    if (this->parent.handle())
+    {
+        this->parent.context().invalidate(this->parent.handle(), this->attr);
+    }
     if (ret < 0)
     {
-        throw Pothos::SystemException("IIOAttr<T>::operator std::string()", "iio_attr_read: " + Poco::Error::getMessage(-ret));
+        throw Pothos::SystemException("IIOAttr<T>::write()", "iio_attr_write_raw: " + Poco::Error::getMessage(-ret));
     }
+}
 
-    return std::string(buf, strnlen(buf, ret));
+template <class T>
+void IIOAttr<T>::load(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    if (!in)
+    {
+        throw Pothos::FileException("IIOAttr<T>::load()", "cannot read " + path);
+    }
+    const std::string blob = contents.str();
+    this->write(blob.data(), blob.size());
+}
+
+template <class T>
+IIOAttr<T>::operator std::string() const
+{
+    //serve the read from a bulk snapshot, taking one if there is none
+    const void *handle = this->parent.handle();
+    if (handle && this->parent.context().attributePrefetch() != 0)
+    {
+        std::string value;
+        if (!this->parent.context().hasSnapshot(handle))
+        {
+            std::vector<std::pair<std::string, std::string>> values;
+            if (this->parent.iio_attr_read_all(values) < 0)
+                values.clear();
+            this->parent.context().storeSnapshot(handle, values);
+        }
+        if (this->parent.context().findSnapshot(handle, this->attr, value))
+            return value;
+    }
+
+    std::vector<char> buf;
+    ssize_t ret = this->readInto(buf);
+    return std::string(buf.data(), strnlen(buf.data(), ret));
 }
 
 template class IIOAttr<IIOChannel>;
 template class IIOAttr<IIODevice>;
+template class IIOAttr<IIODeviceDebug>;
 template class IIOAttrs<IIOChannel>;
 template class IIOAttrs<IIODevice>;
+template class IIOAttrs<IIODeviceDebug>;
 
 IIODevice::IIODevice(std::shared_ptr<IIOContextRaw> ctx, const struct iio_device *device)
     : ctx(ctx), device(device) {}
@@ -178,14 +702,44 @@ unsigned int IIODevice::iio_get_attrs_count() const
     return iio_device_get_attrs_count(this->device);
 }
 
+const char * IIODevice::iio_find_attr(const char *name) const
+{
+    return iio_device_find_attr(this->device, name);
+}
+
 ssize_t IIODevice::iio_attr_read(const char *attr, char *dst, size_t len) const
 {
-    return iio_device_attr_read(this->device, attr, dst, len);
+    return iio_device_attr_read(this->ctx->live(this->device), attr, dst, len);
 }
 
 ssize_t IIODevice::iio_attr_write(const char *attr, const char *src) const
 {
-    return iio_device_attr_write(this->device, attr, src);
+    return iio_device_attr_write(this->ctx->live(this->device), attr, src);
+}
+
+ssize_t IIODevice::iio_attr_write_raw(const char *attr, const void *src, size_t len) const
+{
+    return iio_device_attr_write_raw(this->ctx->live(this->device), attr, src, len);
+}
+
+const void *IIODevice::handle() const
+{
+    return this->device;
+}
+
+IIOContextRaw &IIODevice::context() const
+{
+    return *this->ctx;
+}
+
+int IIODevice::iio_attr_read_all(std::vector<std::pair<std::string, std::string>> &values) const
+{
+    return iio_device_attr_read_all(const_cast<struct iio_device *>(this->ctx->live(this->device)), &collectAttr<struct iio_device>, &values);
+}
+
+std::string IIODevice::iio_attr_path(const char *attr) const
+{
+    return "/sys/bus/iio/devices/" + std::string(iio_device_get_id(this->device)) + "/" + attr;
 }
 
 std::string IIODevice::id(void)
@@ -222,7 +776,7 @@ std::vector<IIOChannel> IIODevice::channels(void)
 IIODevice IIODevice::trigger(void)
 {
     const struct iio_device *trigger;
-    int ret = iio_device_get_trigger(this->device, &trigger);
+    int ret = iio_device_get_trigger(this->ctx->live(this->device), &trigger);
     if (ret)
     {
         throw Pothos::SystemException("IIODevice::trigger()", "iio_device_get_trigger: " + Poco::Error::getMessage(-ret));
@@ -237,7 +791,7 @@ IIODevice IIODevice::trigger(void)
 
 void IIODevice::setTrigger(IIODevice *trigger)
 {
-    int ret = iio_device_set_trigger(this->device, trigger->device);
+    int ret = iio_device_set_trigger(this->ctx->live(this->device), trigger ? this->ctx->live(trigger->device) : nullptr);
     if (ret)
     {
         throw Pothos::SystemException("IIODevice::setTrigger()", "iio_device_set_trigger: " + Poco::Error::getMessage(-ret));
@@ -251,7 +805,7 @@ bool IIODevice::isTrigger(void)
 
 void IIODevice::setKernelBuffersCount(unsigned int nb_buffers)
 {
-    int ret = iio_device_set_kernel_buffers_count(this->device, nb_buffers);
+    int ret = iio_device_set_kernel_buffers_count(this->ctx->live(this->device), nb_buffers);
     if (ret)
     {
         throw Pothos::SystemException("IIODevice::setKernelBuffersCount()", "iio_device_set_kernel_buffers_count: " + Poco::Error::getMessage(-ret));
@@ -260,7 +814,119 @@ void IIODevice::setKernelBuffersCount(unsigned int nb_buffers)
 
 IIOBuffer IIODevice::createBuffer(size_t samples_count, bool cyclic)
 {
-    return IIOBuffer(this->ctx, this, samples_count, cyclic);
+    IIOBuffer buffer(this->ctx, this, samples_count, cyclic);
+
+    //cyclic buffers are pushed once, so there is nothing to overlap
+    const size_t depth = this->ctx->bufferPipelineDepth();
+    if (!cyclic && depth != 0)
+    {
+        buffer.setPipelineDepth(depth);
+    }
+    return buffer;
+}
+
+IIOAttrs<IIODeviceDebug> IIODevice::debugAttributes(void)
+{
+    return IIODeviceDebug(*this).attributes();
+}
+
+uint32_t IIODevice::regRead(uint32_t address)
+{
+    uint32_t value = 0;
+    int ret = iio_device_reg_read(const_cast<struct iio_device *>(this->ctx->live(this->device)), address, &value);
+    if (ret)
+    {
+        throw Pothos::SystemException("IIODevice::regRead()", "iio_device_reg_read(" + std::to_string(address) + "): " + Poco::Error::getMessage(-ret));
+    }
+    return value;
+}
+
+void IIODevice::regWrite(uint32_t address, uint32_t value)
+{
+    int ret = iio_device_reg_write(const_cast<struct iio_device *>(this->ctx->live(this->device)), address, value);
+    if (ret)
+    {
+        throw Pothos::SystemException("IIODevice::regWrite()", "iio_device_reg_write(" + std::to_string(address) + "): " + Poco::Error::getMessage(-ret));
+    }
+}
+
+std::vector<uint32_t> IIODevice::regRead(const std::vector<uint32_t> &addresses)
+{
+    std::vector<uint32_t> values;
+    values.reserve(addresses.size());
+    for (auto address : addresses)
+    {
+        values.push_back(this->regRead(address));
+    }
+    return values;
+}
+
+void IIODevice::regWrite(const std::vector<uint32_t> &addresses, const std::vector<uint32_t> &values)
+{
+    if (addresses.size() != values.size())
+    {
+        throw Pothos::InvalidArgumentException("IIODevice::regWrite()", "address and value counts differ");
+    }
+    for (size_t i = 0; i < addresses.size(); i++)
+    {
+        this->regWrite(addresses[i], values[i]);
+    }
+}
+
+IIOAttrs<IIODeviceDebug> IIODeviceDebug::attributes(void)
+{
+    return IIOAttrs<IIODeviceDebug>(*this);
+}
+
+const char * IIODeviceDebug::iio_get_attr(unsigned int idx) const
+{
+    return iio_device_get_debug_attr(this->dev.device, idx);
+}
+
+unsigned int IIODeviceDebug::iio_get_attrs_count() const
+{
+    return iio_device_get_debug_attrs_count(this->dev.device);
+}
+
+const char * IIODeviceDebug::iio_find_attr(const char *name) const
+{
+    return iio_device_find_debug_attr(this->dev.device, name);
+}
+
+ssize_t IIODeviceDebug::iio_attr_read(const char *attr, char *dst, size_t len) const
+{
+    return iio_device_debug_attr_read(this->dev.ctx->live(this->dev.device), attr, dst, len);
+}
+
+ssize_t IIODeviceDebug::iio_attr_write(const char *attr, const char *src) const
+{
+    return iio_device_debug_attr_write(this->dev.ctx->live(this->dev.device), attr, src);
+}
+
+ssize_t IIODeviceDebug::iio_attr_write_raw(const char *attr, const void *src, size_t len) const
+{
+    return iio_device_debug_attr_write_raw(this->dev.ctx->live(this->dev.device), attr, src, len);
+}
+
+const void *IIODeviceDebug::handle() const
+{
+    //debug attributes have no "_available" companions
+    return nullptr;
+}
+
+IIOContextRaw &IIODeviceDebug::context() const
+{
+    return *this->dev.ctx;
+}
+
+int IIODeviceDebug::iio_attr_read_all(std::vector<std::pair<std::string, std::string>> &values) const
+{
+    return iio_device_debug_attr_read_all(const_cast<struct iio_device *>(this->dev.ctx->live(this->dev.device)), &collectAttr<struct iio_device>, &values);
+}
+
+std::string IIODeviceDebug::iio_attr_path(const char *attr) const
+{
+    return "/sys/kernel/debug/iio/" + std::string(iio_device_get_id(this->dev.device)) + "/" + attr;
 }
 
 IIOChannel::IIOChannel(std::shared_ptr<IIOContextRaw> ctx, struct iio_channel *channel) : ctx(ctx), channel(channel) {}
@@ -275,14 +941,47 @@ unsigned int IIOChannel::iio_get_attrs_count() const
     return iio_channel_get_attrs_count(this->channel);
 }
 
+const char * IIOChannel::iio_find_attr(const char *name) const
+{
+    return iio_channel_find_attr(this->channel, name);
+}
+
 ssize_t IIOChannel::iio_attr_read(const char *attr, char *dst, size_t len) const
 {
-    return iio_channel_attr_read(this->channel, attr, dst, len);
+    return iio_channel_attr_read(this->ctx->live(this->channel), attr, dst, len);
 }
 
 ssize_t IIOChannel::iio_attr_write(const char *attr, const char *src) const
 {
-    return iio_channel_attr_write(this->channel, attr, src);
+    return iio_channel_attr_write(this->ctx->live(this->channel), attr, src);
+}
+
+ssize_t IIOChannel::iio_attr_write_raw(const char *attr, const void *src, size_t len) const
+{
+    return iio_channel_attr_write_raw(this->ctx->live(this->channel), attr, src, len);
+}
+
+const void *IIOChannel::handle() const
+{
+    return this->channel;
+}
+
+IIOContextRaw &IIOChannel::context() const
+{
+    return *this->ctx;
+}
+
+int IIOChannel::iio_attr_read_all(std::vector<std::pair<std::string, std::string>> &values) const
+{
+    return iio_channel_attr_read_all(this->ctx->live(this->channel), &collectAttr<struct iio_channel>, &values);
+}
+
+std::string IIOChannel::iio_attr_path(const char *attr) const
+{
+    const char *filename = iio_channel_attr_get_filename(this->channel, attr);
+    if (!filename)
+        return "";
+    return "/sys/bus/iio/devices/" + std::string(iio_device_get_id(iio_channel_get_device(this->channel))) + "/" + filename;
 }
 
 IIODevice IIOChannel::device(void)
@@ -311,17 +1010,17 @@ IIOAttrs<IIOChannel> IIOChannel::attributes(void)
 
 void IIOChannel::enable(void)
 {
-    iio_channel_enable(this->channel);
+    iio_channel_enable(this->ctx->live(this->channel));
 }
 
 void IIOChannel::disable(void)
 {
-    iio_channel_disable(this->channel);
+    iio_channel_disable(this->ctx->live(this->channel));
 }
 
 bool IIOChannel::isEnabled(void)
 {
-    return iio_channel_is_enabled(this->channel);
+    return iio_channel_is_enabled(this->ctx->live(this->channel));
 }
 
 bool IIOChannel::isOutput(void)
@@ -337,15 +1036,40 @@ bool IIOChannel::isScanElement(void)
 size_t IIOChannel::read(IIOBuffer &buffer, void *dst, size_t sample_count)
 {
     const struct iio_data_format *format = iio_channel_get_data_format(this->channel);
+    if (buffer.pipeline)
+    {
+        //demultiplex the host block, as iio_channel_read() does the iio buffer
+        const size_t length = format->length / 8;
+        const size_t count = std::min(sample_count,
+            size_t((static_cast<char *>(buffer.end()) - static_cast<char *>(buffer.start())) / buffer.step()));
+        const char *src = static_cast<const char *>(buffer.first(*this));
+        for (size_t i = 0; i < count; i++, src += buffer.step())
+        {
+            iio_channel_convert(this->channel, static_cast<char *>(dst) + i * length, src);
+        }
+        return count * length;
+    }
     size_t len = sample_count * format->length;
-    return iio_channel_read(this->channel, buffer.buffer, dst, len);
+    return iio_channel_read(this->ctx->live(this->channel), buffer.buffer, dst, len);
 }
 
 size_t IIOChannel::write(IIOBuffer &buffer, void *dst, size_t sample_count)
 {
     const struct iio_data_format *format = iio_channel_get_data_format(this->channel);
+    if (buffer.pipeline)
+    {
+        const size_t length = format->length / 8;
+        const size_t count = std::min(sample_count,
+            size_t((static_cast<char *>(buffer.end()) - static_cast<char *>(buffer.start())) / buffer.step()));
+        char *out = static_cast<char *>(buffer.first(*this));
+        for (size_t i = 0; i < count; i++, out += buffer.step())
+        {
+            iio_channel_convert_inverse(this->channel, out, static_cast<const char *>(dst) + i * length);
+        }
+        return count * length;
+    }
     size_t len = sample_count * (format->length / 8);
-    return iio_channel_write(this->channel, buffer.buffer, dst, len);
+    return iio_channel_write(this->ctx->live(this->channel), buffer.buffer, dst, len);
 }
 
 Pothos::DType IIOChannel::dtype(void)
@@ -382,10 +1106,188 @@ Pothos::DType IIOChannel::dtype(void)
     }
 }
 
+const struct iio_data_format &IIOChannel::format(void)
+{
+    return *iio_channel_get_data_format(this->channel);
+}
+
+/*!
+ * The host side of a pipelined buffer. A background thread performs the
+ * blocking refills or pushes of the iio buffer, copying samples between it
+ * and a ring of host blocks, so that up to depth transfers are in flight
+ * while the owner works on the block it holds.
+ */
+struct IIOBuffer::Pipeline
+{
+    struct iio_buffer *buffer;
+    bool output;
+    bool blocking;
+    size_t bytes;
+    std::map<const struct iio_channel *, ptrdiff_t> offsets;
+
+    std::vector<std::vector<char>> blocks;
+    std::deque<std::pair<size_t, size_t>> queued;
+    std::deque<size_t> free;
+    size_t current;
+    size_t currentBytes;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread thread;
+    bool started;
+    bool stopping;
+    bool failed;
+    std::string error;
+    int code;
+    int readyFd;
+
+    Pipeline(struct iio_buffer *buffer, size_t depth);
+    ~Pipeline(void);
+    void start(void);
+    void run(void);
+    void throwError(const char *where);
+};
+
+IIOBuffer::Pipeline::Pipeline(struct iio_buffer *buffer, size_t depth)
+    : buffer(buffer), output(false), blocking(true), current(0), currentBytes(0),
+    started(false), stopping(false), failed(false), code(0)
+{
+    //scan offsets are fixed once the buffer is created, even where the
+    //iio buffer itself moves between refills
+    const struct iio_device *dev = iio_buffer_get_device(buffer);
+    const char *base = static_cast<const char *>(iio_buffer_start(buffer));
+    for (unsigned int i = 0; i < iio_device_get_channels_count(dev); i++)
+    {
+        const struct iio_channel *chn = iio_device_get_channel(dev, i);
+        if (!iio_channel_is_enabled(chn))
+            continue;
+        if (iio_channel_is_output(chn)) this->output = true;
+        this->offsets[chn] = static_cast<const char *>(iio_buffer_first(buffer, chn)) - base;
+    }
+    this->bytes = static_cast<const char *>(iio_buffer_end(buffer)) - base;
+
+    //the owner holds one block while depth more are in flight
+    this->blocks.resize(depth + 1, std::vector<char>(this->bytes));
+    for (size_t i = this->output ? 1 : 0; i < this->blocks.size(); i++) this->free.push_back(i);
+    if (this->output) this->currentBytes = this->bytes;
+
+    //ready to read when a refilled block or an error is waiting, and
+    //always ready to write, since push() waits for a free block itself
+    this->readyFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (this->readyFd < 0)
+    {
+        throw Pothos::SystemException("IIOBuffer::Pipeline::Pipeline()", "eventfd: " + Poco::Error::getMessage(errno));
+    }
+}
+
+IIOBuffer::Pipeline::~Pipeline(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->cond.notify_all();
+
+    //the thread may be blocked in a refill or push which only returns when
+    //the device or server responds, so cancel it; the buffer is destroyed
+    //right after, as libiio requires
+    if (this->thread.joinable())
+    {
+        iio_buffer_cancel(this->buffer);
+        this->thread.join();
+    }
+    close(this->readyFd);
+}
+
+void IIOBuffer::Pipeline::start(void)
+{
+    if (this->started)
+        return;
+    int ret = iio_buffer_set_blocking_mode(this->buffer, true);
+    if (ret)
+    {
+        throw Pothos::SystemException("IIOBuffer::Pipeline::start()", "iio_buffer_set_blocking_mode: " + Poco::Error::getMessage(-ret));
+    }
+    this->started = true;
+    this->thread = std::thread(&IIOBuffer::Pipeline::run, this);
+}
+
+void IIOBuffer::Pipeline::run(void)
+{
+    const uint64_t one = 1;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (!this->stopping && !this->failed)
+    {
+        //inputs fill free blocks, outputs drain queued ones
+        size_t block, samples = 0;
+        if (this->output)
+        {
+            if (this->queued.empty())
+            {
+                this->cond.wait(lock);
+                continue;
+            }
+            block = this->queued.front().first;
+            samples = this->queued.front().second;
+        }
+        else
+        {
+            if (this->free.empty())
+            {
+                this->cond.wait(lock);
+                continue;
+            }
+            block = this->free.front();
+            this->free.pop_front();
+        }
+        lock.unlock();
+
+        ssize_t ret;
+        if (this->output)
+        {
+            std::memcpy(iio_buffer_start(this->buffer), this->blocks[block].data(), samples * iio_buffer_step(this->buffer));
+            ret = iio_buffer_push_partial(this->buffer, samples);
+        }
+        else
+        {
+            ret = iio_buffer_refill(this->buffer);
+            if (ret > 0)
+                std::memcpy(this->blocks[block].data(), iio_buffer_start(this->buffer), ret);
+        }
+
+        lock.lock();
+        if (ret < 0)
+        {
+            this->failed = true;
+            this->error = Poco::Error::getMessage(-ret);
+            this->code = -ret;
+            if (!this->output) this->free.push_front(block);
+            if (write(this->readyFd, &one, sizeof(one)) < 0) {}
+        }
+        else if (this->output)
+        {
+            this->queued.pop_front();
+            this->free.push_back(block);
+        }
+        else
+        {
+            this->queued.push_back(std::make_pair(block, size_t(ret)));
+            if (write(this->readyFd, &one, sizeof(one)) < 0) {}
+        }
+        this->cond.notify_all();
+    }
+}
+
+void IIOBuffer::Pipeline::throwError(const char *where)
+{
+    const char *call = this->output ? "iio_buffer_push_partial: " : "iio_buffer_refill: ";
+    throw Pothos::SystemException(where, call + this->error, this->code);
+}
+
 IIOBuffer::IIOBuffer(std::shared_ptr<IIOContextRaw> ctx, IIODevice *device, size_t samples_count, bool cyclic)
     : ctx(ctx)
 {
-    this->buffer = iio_device_create_buffer(device->device, samples_count, cyclic);
+    this->buffer = iio_device_create_buffer(this->ctx->live(device->device), samples_count, cyclic);
     if (!this->buffer)
     {
         throw Pothos::SystemException("IIOBuffer::IIOBuffer()", "iio_device_create_buffer: " + Poco::Error::getMessage(Poco::Error::last()));
@@ -393,7 +1295,7 @@ IIOBuffer::IIOBuffer(std::shared_ptr<IIOContextRaw> ctx, IIODevice *device, size
 }
 
 IIOBuffer::IIOBuffer(IIOBuffer&& other)
-    : ctx(std::move(other.ctx))
+    : ctx(std::move(other.ctx)), pipeline(std::move(other.pipeline))
 {
     this->buffer = other.buffer;
     other.buffer = nullptr;
@@ -401,6 +1303,8 @@ IIOBuffer::IIOBuffer(IIOBuffer&& other)
 
 IIOBuffer::~IIOBuffer(void)
 {
+    //stop the transfer thread before the buffer goes away
+    this->pipeline.reset();
     if (this->buffer) {
         iio_buffer_destroy(this->buffer);
     }
@@ -413,6 +1317,13 @@ IIODevice IIOBuffer::device(void)
 
 void IIOBuffer::setBlockingMode(bool blocking)
 {
+    if (this->pipeline)
+    {
+        //the transfer thread always blocks; this only affects refill()
+        std::lock_guard<std::mutex> lock(this->pipeline->mutex);
+        this->pipeline->blocking = blocking;
+        return;
+    }
     int ret = iio_buffer_set_blocking_mode(this->buffer, blocking);
     if (ret)
     {
@@ -422,6 +1333,8 @@ void IIOBuffer::setBlockingMode(bool blocking)
 
 int IIOBuffer::fd(void)
 {
+    if (this->pipeline)
+        return this->pipeline->readyFd;
     int ret = iio_buffer_get_poll_fd(this->buffer);
     if (ret < 0)
     {
@@ -432,31 +1345,91 @@ int IIOBuffer::fd(void)
 
 size_t IIOBuffer::refill(void)
 {
+    if (this->pipeline)
+    {
+        auto &p = *this->pipeline;
+        if (p.output)
+        {
+            throw Pothos::IllegalStateException("IIOBuffer::refill()", "buffer has output channels");
+        }
+        p.start();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        if (p.currentBytes != 0)
+        {
+            p.free.push_back(p.current);
+            p.currentBytes = 0;
+            p.cond.notify_all();
+        }
+        while (p.queued.empty() && !p.failed)
+        {
+            if (!p.blocking)
+            {
+                throw Pothos::SystemException("IIOBuffer::refill()", "iio_buffer_refill: " + Poco::Error::getMessage(EAGAIN), EAGAIN);
+            }
+            p.cond.wait(lock);
+        }
+        //blocks refilled before a failure are still delivered
+        if (p.queued.empty())
+            p.throwError("IIOBuffer::refill()");
+        uint64_t count;
+        if (read(p.readyFd, &count, sizeof(count)) < 0) {}
+        p.current = p.queued.front().first;
+        p.currentBytes = p.queued.front().second;
+        p.queued.pop_front();
+        return p.currentBytes;
+    }
     ssize_t ret = iio_buffer_refill(this->buffer);
     if (ret < 0)
     {
-        throw Pothos::SystemException("IIOBuffer::refill()", "iio_buffer_refill: " + Poco::Error::getMessage(-ret));
+        throw Pothos::SystemException("IIOBuffer::refill()", "iio_buffer_refill: " + Poco::Error::getMessage(-ret), -ret);
     }
     return (size_t)ret;
 }
 
 size_t IIOBuffer::push(size_t samples_count)
 {
+    if (this->pipeline)
+    {
+        auto &p = *this->pipeline;
+        if (!p.output)
+        {
+            throw Pothos::IllegalStateException("IIOBuffer::push()", "buffer has no output channels");
+        }
+        p.start();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        if (p.failed)
+            p.throwError("IIOBuffer::push()");
+        p.queued.push_back(std::make_pair(p.current, samples_count));
+        p.cond.notify_all();
+        while (p.free.empty() && !p.failed)
+        {
+            p.cond.wait(lock);
+        }
+        if (p.free.empty())
+            p.throwError("IIOBuffer::push()");
+        p.current = p.free.front();
+        p.free.pop_front();
+        return samples_count * iio_buffer_step(this->buffer);
+    }
     ssize_t ret = iio_buffer_push_partial(this->buffer, samples_count);
     if (ret < 0)
     {
-        throw Pothos::SystemException("IIOBuffer::push()", "iio_buffer_push_partial: " + Poco::Error::getMessage(-ret));
+        throw Pothos::SystemException("IIOBuffer::push()", "iio_buffer_push_partial: " + Poco::Error::getMessage(-ret), -ret);
     }
     return (size_t)ret;
 }
 
 void * IIOBuffer::start(void)
 {
+    if (this->pipeline)
+        return this->pipeline->blocks[this->pipeline->current].data();
     return iio_buffer_start(this->buffer);
 }
 
 void * IIOBuffer::end(void)
 {
+    if (this->pipeline)
+        return static_cast<char *>(this->start()) + this->pipeline->currentBytes;
     return iio_buffer_end(this->buffer);
 }
 
@@ -464,3 +1437,33 @@ ptrdiff_t IIOBuffer::step(void)
 {
     return iio_buffer_step(this->buffer);
 }
+
+void * IIOBuffer::first(IIOChannel &channel)
+{
+    if (this->pipeline)
+    {
+        auto it = this->pipeline->offsets.find(this->ctx->live(channel.channel));
+        if (it == this->pipeline->offsets.end())
+            return this->end();
+        return static_cast<char *>(this->start()) + it->second;
+    }
+    return iio_buffer_first(this->buffer, this->ctx->live(channel.channel));
+}
+
+void IIOBuffer::setPipelineDepth(size_t depth)
+{
+    if (this->pipeline && this->pipeline->started)
+    {
+        throw Pothos::IllegalStateException("IIOBuffer::setPipelineDepth()", "buffer has already been used");
+    }
+    this->pipeline.reset();
+    if (depth != 0)
+    {
+        this->pipeline.reset(new Pipeline(this->buffer, depth));
+    }
+}
+
+size_t IIOBuffer::pipelineDepth(void) const
+{
+    return this->pipeline ? this->pipeline->blocks.size() - 1 : 0;
+}
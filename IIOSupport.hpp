@@ -1,34 +1,140 @@
 // Copyright (c) 2016 Fiach Antaw
 // SPDX-License-Identifier: BSL-1.0
 
+#pragma once
 #include <Pothos/Framework.hpp>
 #include <iio.h>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <Poco/SingletonHolder.h>
 #include <string>
 #include <vector>
 #include <iterator>
+#include "IIOConstraint.hpp"
 
 template <class T>
 class IIOAttr;
 class IIOBuffer;
 class IIOChannel;
 class IIODevice;
+class IIODeviceDebug;
 
 /*!
  * IIOContextRaw contains a raw iio_context pointer, which it destroys
  * automatically when it's destructor is called.
+ *
+ * If the POTHOS_IIO_CONTEXT_CACHE environment variable names a file, the
+ * context description is saved there after the local context is created,
+ * and later processes build their topology from that snapshot instead of
+ * scanning sysfs. The live local context is then only created the first
+ * time a device or channel is actually accessed, at which point devices
+ * and channels are looked up by ID and the snapshot is refreshed if the
+ * system has changed.
+ *
+ * The live context is the local context, unless the POTHOS_IIO_CONTEXT_URI
+ * environment variable holds the URI of another, such as "ip:192.168.2.1".
+ * For remote contexts, where every operation is a round trip:
+ *
+ *  - POTHOS_IIO_CONTEXT_TIMEOUT sets the operation timeout in milliseconds,
+ *  - attribute reads are served from bulk snapshots of all the attributes
+ *    of a device or channel, which are refreshed once they are older than
+ *    POTHOS_IIO_ATTR_PREFETCH_MS (default 250, or 0 for local contexts),
+ *  - buffers can transfer ahead on a background thread, with up to
+ *    POTHOS_IIO_PIPELINE_DEPTH blocks queued (default 0, which disables it).
  */
 class IIOContextRaw
 {
     friend class IIOContext;
 private:
     struct iio_context *raw_ptr;
+    std::atomic<struct iio_context *> live_ptr;
+    std::string cachePath;
+    std::mutex mutex;
+    std::map<const struct iio_device *, const struct iio_device *> liveDevices;
+    std::map<const struct iio_channel *, struct iio_channel *> liveChannels;
+    std::map<const void *, std::map<const char *, IIOAttrConstraint>> constraints;
+    std::map<const void *, std::pair<long long, std::map<std::string, std::string>>> snapshots;
+    unsigned int prefetchMs;
+    size_t pipelineDepth;
+    bool isRemote;
 
     IIOContextRaw(void);
 
+    static struct iio_context *create(void);
+    struct iio_context *live(void);
+    static void writeCache(const std::string &path, const struct iio_context *ctx);
+
 public:
     ~IIOContextRaw(void);
+
+    /*!
+     * Check if the topology was loaded from a cached snapshot.
+     */
+    bool cached(void) const;
+
+    /*!
+     * Get the live device or channel corresponding to one in the topology,
+     * creating the live context if needed.
+     */
+    const struct iio_device *live(const struct iio_device *device);
+    struct iio_channel *live(const struct iio_channel *channel);
+
+    /*!
+     * Cache of parsed attribute constraints, keyed by the device or channel
+     * and the attribute name. Writing an attribute drops its own entry and
+     * those of the attributes declared to depend on it (see invalidate()).
+     */
+    bool findConstraint(const void *parent, const char *attr, IIOAttrConstraint &constraint);
+    void storeConstraint(const void *parent, const char *attr, const IIOAttrConstraint &constraint);
+
+    /*!
+     * Snapshots of all attribute values of a device or channel, taken with
+     * one bulk read, which serve attribute reads until they expire. They
+     * are dropped when any attribute of the parent is written, since a
+     * write can change what other attributes read back. A failed bulk read
+     * is stored as an empty snapshot, so that it is not retried on every
+     * read.
+     */
+    bool hasSnapshot(const void *parent);
+    bool findSnapshot(const void *parent, const char *attr, std::string &value);
+    void storeSnapshot(const void *parent, const std::vector<std::pair<std::string, std::string>> &values);
+
+    /*!
+     * Drop what a write of the given attribute makes stale: the snapshot of
+     * its parent, its constraint, and the constraints of a fixed table of
+     * dependents (such as the hardware gain range on the gain control
+     * mode). Writes which change constraints elsewhere, such as a new FIR
+     * filter or LO frequency, drop every constraint and every snapshot,
+     * as they can change what other devices and channels read back too.
+     */
+    void invalidate(const void *parent, const char *attr);
+
+    /*!
+     * Check if writing the attribute can change what other attributes read
+     * back, according to the table used by invalidate(): those of the same
+     * device or channel, or of every one of them when everywhere is set.
+     */
+    static bool hasDependents(const char *attr, bool &everywhere);
+
+    /*!
+     * Check if the live context is remote, which creates it if needed.
+     */
+    bool remote(void);
+
+    /*!
+     * Attribute snapshot lifetime and buffer pipeline depth; zero disables.
+     */
+    unsigned int attributePrefetch(void);
+    void setAttributePrefetch(unsigned int ms);
+    size_t bufferPipelineDepth(void);
+    void setBufferPipelineDepth(size_t depth);
+
+    /*!
+     * Set the timeout of operations on the live context.
+     */
+    void setTimeout(unsigned int ms);
 };
 
 /*!
@@ -63,6 +169,33 @@ public:
      */
     std::string description(void);
 
+    /*!
+     * Check if the context topology was loaded from a cached snapshot.
+     */
+    bool cached(void);
+
+    /*!
+     * Check if the live context is remote, such as a network context.
+     */
+    bool remote(void);
+
+    /*!
+     * Set the timeout for operations on the context, in milliseconds.
+     */
+    void setTimeout(unsigned int ms);
+
+    /*!
+     * Set how long bulk attribute snapshots serve reads, in milliseconds.
+     * Zero reads every attribute from the device.
+     */
+    void setAttributePrefetch(unsigned int ms);
+
+    /*!
+     * Set the pipeline depth of buffers created later; see
+     * IIOBuffer::setPipelineDepth(). Zero transfers in the calling thread.
+     */
+    void setBufferPipelineDepth(size_t depth);
+
     /*!
      * The devices() method returns a set of IIODevice objects representing
      * devices available through this libiio context.
@@ -122,6 +255,20 @@ public:
     IIOAttr<T> at(const std::string& name);
     size_t size() const;
     bool empty() const;
+
+    /*!
+     * Read the values of all attributes, in order, with a single bulk read
+     * where the backend supports it. Attributes which cannot be read are
+     * left out.
+     */
+    std::vector<std::pair<std::string, std::string>> values();
+
+    /*!
+     * Take a bulk snapshot of all attributes, so that following reads are
+     * served without a round trip while it lasts. Only has an effect when
+     * attribute prefetch is enabled.
+     */
+    void prefetch();
 };
 
 /*!
@@ -130,11 +277,14 @@ public:
 template <class T>
 class IIOAttr
 {
+    friend class IIOAttrs<T>;
     friend class IIOAttrs<T>::Iterator;
 private:
     IIOAttr<T>(T parent, const char* attr);
     T parent;
     const char* attr;
+
+    ssize_t readInto(std::vector<char> &buf) const;
 public:
     /*!
      * Get the name of the attribute.
@@ -146,6 +296,46 @@ public:
      */
     std::string value();
 
+    /*!
+     * Get the complete contents of the attribute, which may be binary.
+     * The read buffer grows until the whole attribute fits.
+     */
+    std::string data() const;
+
+    /*!
+     * Write length bytes of binary data to the attribute in one operation.
+     */
+    void write(const void *src, size_t length);
+
+    /*!
+     * Write the contents of a file, such as a filter profile, to the
+     * attribute in one operation.
+     */
+    void load(const std::string &path);
+
+    /*!
+     * Get the sysfs (or debugfs) path of the attribute, or an empty string
+     * if it has none.
+     */
+    std::string path() const;
+
+    /*!
+     * Check if the attribute can be written. Attributes without a file,
+     * and all attributes of remote contexts, are assumed to be writable.
+     */
+    bool writable();
+
+    /*!
+     * Get the values accepted by this attribute, parsed from its
+     * "_available" companion attribute and cached.
+     */
+    IIOAttrConstraint constraint();
+
+    /*!
+     * Assign a value, which is first checked against the attribute's
+     * constraint: values within a range are snapped to its step, and
+     * values which are not accepted throw without writing to the device.
+     */
     IIOAttr<T>& operator= (const std::string& other);
     operator std::string() const;
 };
@@ -160,6 +350,7 @@ class IIODevice
     friend class IIOBuffer;
     friend class IIOChannel;
     friend class IIOContext;
+    friend class IIODeviceDebug;
 private:
     std::shared_ptr<IIOContextRaw> ctx;
     const struct iio_device *device;
@@ -168,8 +359,14 @@ private:
 
     const char * iio_get_attr(unsigned int idx) const;
     unsigned int iio_get_attrs_count() const;
+    const char * iio_find_attr(const char *name) const;
     ssize_t iio_attr_read(const char *attr, char *dst, size_t len) const;
     ssize_t iio_attr_write(const char *attr, const char *src) const;
+    ssize_t iio_attr_write_raw(const char *attr, const void *src, size_t len) const;
+    const void *handle() const;
+    IIOContextRaw &context() const;
+    int iio_attr_read_all(std::vector<std::pair<std::string, std::string>> &values) const;
+    std::string iio_attr_path(const char *attr) const;
 public:
 
     bool operator==(IIODevice other) const
@@ -233,6 +430,66 @@ public:
      * Create an IIO buffer associated with this device.
      */
     IIOBuffer createBuffer(size_t samples_count, bool cyclic);
+
+    /*!
+     * The debugAttributes() method returns an object exposing the debug
+     * attributes of this IIO device, from its debugfs directory.
+     */
+    IIOAttrs<IIODeviceDebug> debugAttributes(void);
+
+    /*!
+     * Read a device register through the "direct_reg_access" debug attribute.
+     */
+    uint32_t regRead(uint32_t address);
+
+    /*!
+     * Write a device register through the "direct_reg_access" debug attribute.
+     */
+    void regWrite(uint32_t address, uint32_t value);
+
+    /*!
+     * Read a list of device registers, in order.
+     */
+    std::vector<uint32_t> regRead(const std::vector<uint32_t> &addresses);
+
+    /*!
+     * Write a list of device registers, in order. Writing stops at the first
+     * register which fails.
+     */
+    void regWrite(const std::vector<uint32_t> &addresses, const std::vector<uint32_t> &values);
+};
+
+/*!
+ * IIODeviceDebug gives IIOAttrs access to the debug attributes of a device.
+ */
+class IIODeviceDebug
+{
+    friend class IIOAttr<IIODeviceDebug>;
+    friend class IIOAttrs<IIODeviceDebug>;
+    friend class IIODevice;
+private:
+    IIODevice dev;
+
+    IIODeviceDebug(IIODevice dev) : dev(dev) {}
+
+    IIOAttrs<IIODeviceDebug> attributes(void);
+
+    const char * iio_get_attr(unsigned int idx) const;
+    unsigned int iio_get_attrs_count() const;
+    const char * iio_find_attr(const char *name) const;
+    ssize_t iio_attr_read(const char *attr, char *dst, size_t len) const;
+    ssize_t iio_attr_write(const char *attr, const char *src) const;
+    ssize_t iio_attr_write_raw(const char *attr, const void *src, size_t len) const;
+    const void *handle() const;
+    IIOContextRaw &context() const;
+    int iio_attr_read_all(std::vector<std::pair<std::string, std::string>> &values) const;
+    std::string iio_attr_path(const char *attr) const;
+public:
+
+    bool operator==(IIODeviceDebug other) const
+    {
+        return this->dev == other.dev;
+    }
 };
 
 /*!
@@ -243,8 +500,10 @@ class IIOBuffer {
     friend class IIODevice;
     friend class IIOChannel;
 private:
+    struct Pipeline;
     std::shared_ptr<IIOContextRaw> ctx;
     struct iio_buffer *buffer;
+    std::unique_ptr<Pipeline> pipeline;
 
     IIOBuffer(std::shared_ptr<IIOContextRaw> ctx, IIODevice *device, size_t samples_count, bool cyclic);
 
@@ -271,7 +530,7 @@ public:
      * Fill the buffer with fresh samples from the owning device.
      *
      * Note that this function is only valid for buffers containing input
-     * channels.
+     * channels. On failure, the exception code holds the errno value.
      */
     size_t refill(void);
 
@@ -279,7 +538,7 @@ public:
      * Push the buffer to the owning device.
      *
      * Note that this function is only valid for buffers containing output
-     * channels.
+     * channels. On failure, the exception code holds the errno value.
      */
     size_t push(size_t samples_count);
 
@@ -297,6 +556,25 @@ public:
      * Get the step size between two samples of one channel.
      */
     ptrdiff_t step(void);
+
+    /*!
+     * Get the address of the first sample of the given channel in the buffer.
+     */
+    void* first(IIOChannel &channel);
+
+    /*!
+     * Refill up to depth blocks ahead (for input buffers), or queue up to
+     * depth pushes (for output buffers), on a background thread, so that
+     * the round trip of each transfer overlaps with the processing of
+     * another block. libiio allows one transfer per buffer at a time, so
+     * this adds no concurrency on the wire, and each block is copied once
+     * between the iio buffer and host memory. Samples are accessed in the
+     * host blocks, which start(), end() and first() point into, and fd()
+     * becomes readable when a refilled block is ready. Must be called
+     * before the first transfer; zero disables pipelining.
+     */
+    void setPipelineDepth(size_t depth);
+    size_t pipelineDepth(void) const;
 };
 
 /*!
@@ -305,6 +583,7 @@ public:
 class IIOChannel {
     friend class IIOAttr<IIOChannel>;
     friend class IIOAttrs<IIOChannel>;
+    friend class IIOBuffer;
     friend class IIODevice;
 private:
     std::shared_ptr<IIOContextRaw> ctx;
@@ -314,8 +593,14 @@ private:
 
     const char * iio_get_attr(unsigned int idx) const;
     unsigned int iio_get_attrs_count() const;
+    const char * iio_find_attr(const char *name) const;
     ssize_t iio_attr_read(const char *attr, char *dst, size_t len) const;
     ssize_t iio_attr_write(const char *attr, const char *src) const;
+    ssize_t iio_attr_write_raw(const char *attr, const void *src, size_t len) const;
+    const void *handle() const;
+    IIOContextRaw &context() const;
+    int iio_attr_read_all(std::vector<std::pair<std::string, std::string>> &values) const;
+    std::string iio_attr_path(const char *attr) const;
 public:
 
     bool operator==(IIOChannel other) const
@@ -395,5 +680,10 @@ public:
      * Get the DType of this channel.
      */
     Pothos::DType dtype(void);
+
+    /*!
+     * Get the format of samples belonging to this channel.
+     */
+    const struct iio_data_format &format(void);
 };
 
@@ -0,0 +1,172 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "IIOConvert.hpp"
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#include <vector>
+
+/*!
+ * IIOUpconverter is a digital upconverter for a pair of I/Q output channels.
+ * It interpolates a complex baseband stream with a polyphase filter, shifts it
+ * with a numerically controlled oscillator and writes the result straight into
+ * strided IIO buffer memory, so the full-rate signal is never materialized
+ * anywhere else.
+ */
+class IIOUpconverter
+{
+private:
+    size_t factor;
+    size_t tapsPerPhase;
+
+    //phaseTaps[j*K + k] is prototype tap k*L + j, applied to the k-th newest input
+    std::vector<float> phaseTaps;
+
+    //the K-1 previous inputs followed by the current block
+    std::vector<std::complex<float>> history;
+
+    double frequency;
+
+    //NCO phase at the start of the next block, in cycles
+    double phase;
+
+public:
+    /*!
+     * Create an upconverter which interpolates by the given factor using the
+     * given prototype lowpass. If no taps are given, a windowed-sinc prototype
+     * with 8 taps per phase is designed.
+     */
+    IIOUpconverter(size_t interpolation = 1, std::vector<float> taps = std::vector<float>()) :
+        factor(interpolation), frequency(0.0), phase(0.0)
+    {
+        if (interpolation == 0)
+        {
+            throw Pothos::InvalidArgumentException("IIOUpconverter::IIOUpconverter()", "interpolation must be at least 1");
+        }
+        if (taps.empty())
+        {
+            taps = designPrototype(interpolation, interpolation == 1 ? 1 : 8);
+        }
+        if (taps.size() % interpolation != 0)
+        {
+            taps.resize((taps.size() / interpolation + 1) * interpolation, 0.0f);
+        }
+        this->tapsPerPhase = taps.size() / interpolation;
+        this->phaseTaps.resize(taps.size());
+        for (size_t j = 0; j < interpolation; j++)
+        {
+            for (size_t k = 0; k < this->tapsPerPhase; k++)
+            {
+                this->phaseTaps[j * this->tapsPerPhase + k] = taps[k * interpolation + j];
+            }
+        }
+        this->reset();
+    }
+
+    /*!
+     * Design a windowed-sinc prototype lowpass for the given interpolation
+     * with tapsPerPhase taps per polyphase branch and a passband gain of one
+     * after interpolation.
+     */
+    static std::vector<float> designPrototype(size_t interpolation, size_t tapsPerPhase)
+    {
+        const double pi = std::acos(-1.0);
+        const size_t len = interpolation * tapsPerPhase;
+        if (len == 1) return std::vector<float>(1, 1.0f);
+        const double centre = (len - 1) / 2.0;
+        std::vector<float> taps(len);
+        double sum = 0.0;
+        for (size_t i = 0; i < len; i++)
+        {
+            const double t = (i - centre) / interpolation;
+            const double sinc = (t == 0.0) ? 1.0 : std::sin(pi * t) / (pi * t);
+            const double x = 2.0 * pi * i / (len - 1);
+            const double window = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+            taps[i] = static_cast<float>(sinc * window);
+            sum += taps[i];
+        }
+        for (auto &t : taps) t = static_cast<float>(t * interpolation / sum);
+        return taps;
+    }
+
+    /*!
+     * Get the interpolation factor.
+     */
+    size_t interpolation(void) const
+    {
+        return this->factor;
+    }
+
+    /*!
+     * Set the NCO frequency as a fraction of the output sample rate.
+     */
+    void setFrequency(double frequency)
+    {
+        this->frequency = frequency;
+    }
+
+    /*!
+     * Get the NCO frequency as a fraction of the output sample rate.
+     */
+    double getFrequency(void) const
+    {
+        return this->frequency;
+    }
+
+    /*!
+     * Clear the filter history and NCO phase.
+     */
+    void reset(void)
+    {
+        this->history.assign(this->tapsPerPhase - 1, std::complex<float>());
+        this->phase = 0.0;
+    }
+
+    /*!
+     * Upconvert count baseband samples, writing count * interpolation() I
+     * and Q samples to the strided device buffer locations iDst and qDst.
+     */
+    void process(const std::complex<float> *input, size_t count,
+        const IIOSampleConverter &iConv, void *iDst,
+        const IIOSampleConverter &qConv, void *qDst, ptrdiff_t step)
+    {
+        const size_t k0 = this->tapsPerPhase - 1;
+        this->history.insert(this->history.end(), input, input + count);
+
+        const double pi = std::acos(-1.0);
+        std::complex<float> phasor(std::polar(1.0, 2.0 * pi * this->phase));
+        const std::complex<float> rotation(std::polar(1.0, 2.0 * pi * this->frequency));
+
+        char *iOut = static_cast<char *>(iDst);
+        char *qOut = static_cast<char *>(qDst);
+        for (size_t n = 0; n < count; n++)
+        {
+            //newest input is history[k0 + n], oldest in the window is history[n]
+            const std::complex<float> *x = &this->history[n];
+            for (size_t j = 0; j < this->factor; j++)
+            {
+                const float *h = &this->phaseTaps[j * this->tapsPerPhase];
+                std::complex<float> acc;
+                for (size_t k = 0; k < this->tapsPerPhase; k++)
+                {
+                    acc += h[k] * x[k0 - k];
+                }
+                acc *= phasor;
+                phasor *= rotation;
+                iConv.fromFloat(acc.real(), iOut);
+                qConv.fromFloat(acc.imag(), qOut);
+                iOut += step;
+                qOut += step;
+            }
+        }
+
+        //advance the NCO phase exactly so rounding in the float phasor
+        //doesn't accumulate across blocks
+        this->phase = std::fmod(this->phase + this->frequency * count * this->factor, 1.0);
+
+        //keep the K-1 newest inputs as history for the next block
+        this->history.erase(this->history.begin(), this->history.end() - k0);
+    }
+};
@@ -0,0 +1,295 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "IIOVrt.hpp"
+#include <Pothos/Framework.hpp>
+#include <Poco/Error.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+//VRT header fields, see VITA 49.0 section 6.1.1
+static const uint32_t VRT_TYPE_IF_DATA_SID = 1;
+static const uint32_t VRT_TYPE_CONTEXT = 4;
+static const uint32_t VRT_TSI_UTC = 1;
+static const uint32_t VRT_TSF_REAL_TIME = 2;
+static const size_t VRT_PREFIX_WORDS = 5;
+static const size_t VRT_MAX_PACKET_WORDS = 0xffff;
+
+//context indicator field 0 bits
+static const uint32_t CIF0_CHANGE = 1u << 31;
+static const uint32_t CIF0_BANDWIDTH = 1u << 29;
+static const uint32_t CIF0_RF_FREQUENCY = 1u << 27;
+static const uint32_t CIF0_GAIN = 1u << 23;
+static const uint32_t CIF0_SAMPLE_RATE = 1u << 21;
+
+static void putPrefix(uint32_t *words, uint32_t type, unsigned count, size_t packetWords, uint32_t streamId, long long timeNs)
+{
+    long long seconds = timeNs / 1000000000;
+    long long nanos = timeNs % 1000000000;
+    if (nanos < 0)
+    {
+        seconds--;
+        nanos += 1000000000;
+    }
+    const uint64_t picos = static_cast<uint64_t>(nanos) * 1000;
+
+    words[0] = htonl((type << 28) | (VRT_TSI_UTC << 22) | (VRT_TSF_REAL_TIME << 20) |
+        ((count & 0xf) << 16) | static_cast<uint32_t>(packetWords));
+    words[1] = htonl(streamId);
+    words[2] = htonl(static_cast<uint32_t>(seconds));
+    words[3] = htonl(static_cast<uint32_t>(picos >> 32));
+    words[4] = htonl(static_cast<uint32_t>(picos));
+}
+
+static void putFixed64(std::vector<uint32_t> &words, double value)
+{
+    //64-bit two's complement with a radix point after bit 20
+    const uint64_t fixed = static_cast<uint64_t>(std::llround(value * (1 << 20)));
+    words.push_back(htonl(static_cast<uint32_t>(fixed >> 32)));
+    words.push_back(htonl(static_cast<uint32_t>(fixed)));
+}
+
+IIOVrtContext::IIOVrtContext(void)
+    : sampleRate(std::numeric_limits<double>::quiet_NaN()),
+      bandwidth(std::numeric_limits<double>::quiet_NaN()),
+      rfFrequency(std::numeric_limits<double>::quiet_NaN()),
+      gain(std::numeric_limits<double>::quiet_NaN())
+{
+}
+
+bool IIOVrtContext::operator==(const IIOVrtContext &other) const
+{
+    auto same = [](double a, double b) { return (std::isnan(a) && std::isnan(b)) || a == b; };
+    return same(this->sampleRate, other.sampleRate) && same(this->bandwidth, other.bandwidth) &&
+        same(this->rfFrequency, other.rfFrequency) && same(this->gain, other.gain);
+}
+
+IIOVrtSender::IIOVrtSender(void)
+    : fd(-1), streamId(0), payloadSize(1440), step(0), identity(true),
+      dataCount(0), contextCount(0), haveContext(false), packets(0)
+{
+}
+
+IIOVrtSender::~IIOVrtSender(void)
+{
+    this->close();
+}
+
+void IIOVrtSender::open(const std::string &address, int port, uint32_t streamId, const std::string &interface)
+{
+    this->close();
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+    {
+        throw Pothos::InvalidArgumentException("IIOVrtSender::open()", "invalid destination address: " + address);
+    }
+    struct in_addr ifaddr = {};
+    if (!interface.empty() && inet_pton(AF_INET, interface.c_str(), &ifaddr) != 1)
+    {
+        throw Pothos::InvalidArgumentException("IIOVrtSender::open()", "invalid interface address: " + interface);
+    }
+
+    this->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (this->fd < 0)
+    {
+        throw Pothos::SystemException("IIOVrtSender::open()", "socket: " + Poco::Error::getMessage(errno));
+    }
+    if (IN_MULTICAST(ntohl(addr.sin_addr.s_addr)))
+    {
+        unsigned char ttl = 1, loop = 1;
+        setsockopt(this->fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(this->fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        if (!interface.empty() && setsockopt(this->fd, IPPROTO_IP, IP_MULTICAST_IF, &ifaddr, sizeof(ifaddr)) < 0)
+        {
+            int err = errno;
+            this->close();
+            throw Pothos::SystemException("IIOVrtSender::open()", "IP_MULTICAST_IF: " + Poco::Error::getMessage(err));
+        }
+    }
+    if (connect(this->fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        int err = errno;
+        this->close();
+        throw Pothos::SystemException("IIOVrtSender::open()", "connect: " + Poco::Error::getMessage(err));
+    }
+
+    this->streamId = streamId;
+    this->dataCount = 0;
+    this->contextCount = 0;
+    this->haveContext = false;
+    this->packets = 0;
+}
+
+void IIOVrtSender::close(void)
+{
+    if (this->fd >= 0)
+    {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+}
+
+bool IIOVrtSender::isOpen(void) const
+{
+    return this->fd >= 0;
+}
+
+void IIOVrtSender::setPayloadSize(size_t bytes)
+{
+    if (bytes < 4)
+    {
+        throw Pothos::RangeException("IIOVrtSender::setPayloadSize()", "payload size must be at least one word");
+    }
+    this->payloadSize = std::min(bytes, (VRT_MAX_PACKET_WORDS - VRT_PREFIX_WORDS) * 4);
+}
+
+void IIOVrtSender::setLayout(const std::vector<IIOVrtField> &fields, size_t step)
+{
+    //map each byte of a big-endian scan to its source byte
+    this->step = step;
+    this->byteMap.resize(step);
+    for (size_t i = 0; i < step; i++) this->byteMap[i] = i;
+    for (const auto &f : fields)
+    {
+        if (f.bigEndian || f.offset + f.size > step)
+            continue;
+        for (size_t k = 0; k < f.size; k++)
+        {
+            this->byteMap[f.offset + k] = f.offset + f.size - 1 - k;
+        }
+    }
+    this->identity = true;
+    for (size_t i = 0; i < step; i++)
+    {
+        if (this->byteMap[i] != i) this->identity = false;
+    }
+}
+
+void IIOVrtSender::sendData(const void *scans, size_t count, long long timeNs, double sampleRate)
+{
+    if (this->fd < 0 || this->step == 0 || count == 0)
+        return;
+
+    //convert to network byte order in one pass unless already big-endian
+    const uint8_t *payload = static_cast<const uint8_t *>(scans);
+    if (!this->identity)
+    {
+        this->scratch.resize(count * this->step);
+        const size_t *map = this->byteMap.data();
+        for (size_t n = 0; n < count; n++)
+        {
+            const uint8_t *src = payload + n * this->step;
+            uint8_t *dst = this->scratch.data() + n * this->step;
+            for (size_t i = 0; i < this->step; i++) dst[i] = src[map[i]];
+        }
+        payload = this->scratch.data();
+    }
+
+    //each packet carries a whole number of scans, padded to a whole word
+    static const uint8_t padding[4] = {0, 0, 0, 0};
+    const size_t scansPerPacket = std::max<size_t>(this->payloadSize / this->step, 1);
+    const size_t numPackets = (count + scansPerPacket - 1) / scansPerPacket;
+    this->headers.resize(numPackets * VRT_PREFIX_WORDS);
+    std::vector<struct iovec> iovs(numPackets * 3);
+    std::vector<struct mmsghdr> msgs(numPackets);
+
+    for (size_t p = 0; p < numPackets; p++)
+    {
+        const size_t first = p * scansPerPacket;
+        const size_t n = std::min(scansPerPacket, count - first);
+        const size_t bytes = n * this->step;
+        const size_t pad = (4 - bytes % 4) % 4;
+        const long long packetNs = (sampleRate > 0.0) ? timeNs + std::llround(first * (1e9 / sampleRate)) : timeNs;
+
+        uint32_t *prefix = &this->headers[p * VRT_PREFIX_WORDS];
+        putPrefix(prefix, VRT_TYPE_IF_DATA_SID, this->dataCount++, VRT_PREFIX_WORDS + (bytes + pad) / 4, this->streamId, packetNs);
+
+        struct iovec *iov = &iovs[p * 3];
+        iov[0].iov_base = prefix;
+        iov[0].iov_len = VRT_PREFIX_WORDS * 4;
+        iov[1].iov_base = const_cast<uint8_t *>(payload + first * this->step);
+        iov[1].iov_len = bytes;
+        iov[2].iov_base = const_cast<uint8_t *>(padding);
+        iov[2].iov_len = pad;
+
+        std::memset(&msgs[p], 0, sizeof(msgs[p]));
+        msgs[p].msg_hdr.msg_iov = iov;
+        msgs[p].msg_hdr.msg_iovlen = pad ? 3 : 2;
+    }
+
+    this->sendBatch(msgs);
+}
+
+void IIOVrtSender::sendContext(const IIOVrtContext &context, long long timeNs)
+{
+    if (this->fd < 0)
+        return;
+
+    std::vector<uint32_t> words(VRT_PREFIX_WORDS);
+    uint32_t cif0 = 0;
+    if (this->haveContext && !(context == this->lastContext)) cif0 |= CIF0_CHANGE;
+    if (!std::isnan(context.bandwidth)) cif0 |= CIF0_BANDWIDTH;
+    if (!std::isnan(context.rfFrequency)) cif0 |= CIF0_RF_FREQUENCY;
+    if (!std::isnan(context.gain)) cif0 |= CIF0_GAIN;
+    if (!std::isnan(context.sampleRate)) cif0 |= CIF0_SAMPLE_RATE;
+    words.push_back(htonl(cif0));
+
+    //fields follow in descending order of their indicator bits
+    if (cif0 & CIF0_BANDWIDTH) putFixed64(words, context.bandwidth);
+    if (cif0 & CIF0_RF_FREQUENCY) putFixed64(words, context.rfFrequency);
+    if (cif0 & CIF0_GAIN)
+    {
+        //stage 1 gain in the low half, in dB with a radix point after bit 7
+        const int16_t gain = static_cast<int16_t>(std::lround(context.gain * (1 << 7)));
+        words.push_back(htonl(static_cast<uint16_t>(gain)));
+    }
+    if (cif0 & CIF0_SAMPLE_RATE) putFixed64(words, context.sampleRate);
+
+    putPrefix(words.data(), VRT_TYPE_CONTEXT, this->contextCount++, words.size(), this->streamId, timeNs);
+
+    struct iovec iov;
+    iov.iov_base = words.data();
+    iov.iov_len = words.size() * 4;
+    std::vector<struct mmsghdr> msgs(1);
+    std::memset(&msgs[0], 0, sizeof(msgs[0]));
+    msgs[0].msg_hdr.msg_iov = &iov;
+    msgs[0].msg_hdr.msg_iovlen = 1;
+    this->sendBatch(msgs);
+
+    this->lastContext = context;
+    this->haveContext = true;
+}
+
+void IIOVrtSender::sendBatch(std::vector<struct mmsghdr> &msgs)
+{
+    size_t sent = 0;
+    while (sent < msgs.size())
+    {
+        int ret = sendmmsg(this->fd, msgs.data() + sent, msgs.size() - sent, 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR) continue;
+            //no receiver yet on a connected socket, or transient shortage of
+            //buffers: the datagrams are dropped as they would be on the wire
+            if (errno == ECONNREFUSED || errno == ENOBUFS || errno == EAGAIN) return;
+            throw Pothos::SystemException("IIOVrtSender::sendBatch()", "sendmmsg: " + Poco::Error::getMessage(errno));
+        }
+        sent += ret;
+        this->packets += ret;
+    }
+}
+
+unsigned long long IIOVrtSender::packetsSent(void) const
+{
+    return this->packets;
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * The layout of one sample within a scan, used to convert scans to the
+ * big-endian byte order of VRT payloads.
+ */
+struct IIOVrtField
+{
+    size_t offset;
+    size_t size;
+    bool bigEndian;
+};
+
+/*!
+ * Context fields describing a VRT stream. Fields which are NaN are omitted
+ * from context packets.
+ */
+struct IIOVrtContext
+{
+    double sampleRate;
+    double bandwidth;
+    double rfFrequency;
+    double gain;
+
+    IIOVrtContext(void);
+    bool operator==(const IIOVrtContext &other) const;
+};
+
+/*!
+ * IIOVrtSender forms VITA 49 (VRT) IF data packets directly from interleaved
+ * IIO scans and sends them over UDP, along with context packets describing
+ * the stream.
+ *
+ * Data packets carry a stream ID and a UTC integer timestamp with a
+ * real-time fractional timestamp in picoseconds. All packets produced from
+ * one block of scans are sent with a single sendmmsg() call. Scans are
+ * referenced in place when they are already big-endian, and otherwise
+ * byte-swapped in a single pass.
+ */
+class IIOVrtSender
+{
+private:
+    int fd;
+    uint32_t streamId;
+    size_t payloadSize;
+    size_t step;
+    std::vector<size_t> byteMap;
+    bool identity;
+    unsigned dataCount;
+    unsigned contextCount;
+    bool haveContext;
+    IIOVrtContext lastContext;
+    unsigned long long packets;
+
+    //storage reused between calls to sendData()
+    std::vector<uint8_t> scratch;
+    std::vector<uint32_t> headers;
+
+    void sendBatch(std::vector<struct mmsghdr> &msgs);
+
+public:
+    IIOVrtSender(void);
+    ~IIOVrtSender(void);
+    IIOVrtSender(const IIOVrtSender &) = delete;
+    IIOVrtSender &operator=(const IIOVrtSender &) = delete;
+
+    /*!
+     * Open a UDP socket sending to the given IPv4 address and port.
+     * Multicast destinations are sent with a TTL of one and with loopback
+     * enabled, so that local receivers see the stream. They leave through
+     * the interface with the given IPv4 address, or the one chosen by the
+     * routing table when it is empty.
+     */
+    void open(const std::string &address, int port, uint32_t streamId, const std::string &interface = "");
+
+    void close(void);
+
+    bool isOpen(void) const;
+
+    /*!
+     * Set the maximum number of payload bytes in each data packet.
+     */
+    void setPayloadSize(size_t bytes);
+
+    /*!
+     * Set the layout of each scan of step bytes.
+     */
+    void setLayout(const std::vector<IIOVrtField> &fields, size_t step);
+
+    /*!
+     * Send count interleaved scans as one or more data packets. timeNs is
+     * the host time of the first scan, and sampleRate is used to time-stamp
+     * the packets which follow it.
+     */
+    void sendData(const void *scans, size_t count, long long timeNs, double sampleRate);
+
+    /*!
+     * Send a context packet, marking it as changed if it differs from the
+     * last context packet sent.
+     */
+    void sendContext(const IIOVrtContext &context, long long timeNs);
+
+    /*!
+     * Get the number of packets sent since the sender was opened.
+     */
+    unsigned long long packetsSent(void) const;
+};
@@ -0,0 +1,282 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework.hpp>
+#include <Poco/Error.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include "IIOWatcher.hpp"
+
+template <class T>
+struct IIOAttrWatcher::AttrGroup : IIOAttrWatcher::Group
+{
+    IIOAttrs<T> attrs;
+
+    AttrGroup(IIOAttrs<T> attrs) : attrs(attrs) {}
+
+    std::vector<std::pair<std::string, std::string>> values(void)
+    {
+        return this->attrs.values();
+    }
+};
+
+IIOAttrWatcher::IIOAttrWatcher(const Callback &callback)
+    : callback(callback), wakeFd(-1), running(false)
+{
+    this->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (this->wakeFd < 0)
+    {
+        throw Pothos::SystemException("IIOAttrWatcher::IIOAttrWatcher()", "eventfd: " + Poco::Error::getMessage(errno));
+    }
+}
+
+IIOAttrWatcher::~IIOAttrWatcher(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->running = false;
+    }
+    if (this->thread.joinable())
+    {
+        this->wake();
+        this->thread.join();
+    }
+    for (auto &e : this->entries)
+    {
+        if (e.fd >= 0) close(e.fd);
+    }
+    for (auto fd : this->closing) close(fd);
+    close(this->wakeFd);
+}
+
+template <class T>
+void IIOAttrWatcher::watch(const std::string &key, IIOAttrs<T> attrs, const std::string &name)
+{
+    auto attr = attrs.at(name);
+
+    Entry e;
+    e.key = key;
+    e.name = name;
+    e.path = attr.path();
+    e.fd = -1;
+    e.notifies = false;
+    try
+    {
+        e.value = attr.value();
+    }
+    catch (const Pothos::Exception &) {}
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto it = this->entries.begin(); it != this->entries.end(); ++it)
+    {
+        if (it->key != key)
+            continue;
+        if (it->fd >= 0) this->closing.push_back(it->fd);
+        this->entries.erase(it);
+        break;
+    }
+
+    //attributes of the same device or channel share a bulk read
+    for (const auto &other : this->entries)
+    {
+        auto group = std::dynamic_pointer_cast<AttrGroup<T>>(other.group);
+        if (group && group->attrs.begin() == attrs.begin())
+        {
+            e.group = group;
+            break;
+        }
+    }
+    if (!e.group)
+    {
+        e.group = std::make_shared<AttrGroup<T>>(attrs);
+    }
+    this->entries.push_back(e);
+
+    if (!this->thread.joinable())
+    {
+        this->running = true;
+        this->thread = std::thread(&IIOAttrWatcher::run, this);
+    }
+    else
+    {
+        this->wake();
+    }
+}
+
+template void IIOAttrWatcher::watch<IIODevice>(const std::string &, IIOAttrs<IIODevice>, const std::string &);
+template void IIOAttrWatcher::watch<IIOChannel>(const std::string &, IIOAttrs<IIOChannel>, const std::string &);
+
+void IIOAttrWatcher::unwatch(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto it = this->entries.begin(); it != this->entries.end(); ++it)
+    {
+        if (it->key != key)
+            continue;
+        //descriptors are only closed by the watcher thread, which may be polling them
+        if (it->fd >= 0) this->closing.push_back(it->fd);
+        this->entries.erase(it);
+        this->wake();
+        return;
+    }
+}
+
+std::vector<std::string> IIOAttrWatcher::watched(void)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<std::string> keys;
+    for (const auto &e : this->entries) keys.push_back(e.key);
+    return keys;
+}
+
+void IIOAttrWatcher::wake(void)
+{
+    const uint64_t one = 1;
+    if (write(this->wakeFd, &one, sizeof(one)) < 0) {}
+}
+
+static bool readSysfs(int fd, std::string &value)
+{
+    char buf[4096];
+    ssize_t ret = pread(fd, buf, sizeof(buf), 0);
+    if (ret < 0)
+        return false;
+    while (ret > 0 && (buf[ret - 1] == '\n' || buf[ret - 1] == '\0')) ret--;
+    value.assign(buf, ret);
+    return true;
+}
+
+void IIOAttrWatcher::run(void)
+{
+    typedef std::chrono::steady_clock Clock;
+    int interval = MIN_INTERVAL_MS;
+    auto nextRead = Clock::now() + std::chrono::milliseconds(interval);
+
+    std::vector<struct pollfd> fds;
+    std::vector<std::string> fdKeys;
+    std::vector<std::pair<std::string, std::string>> changes;
+
+    while (true)
+    {
+        fds.clear();
+        fdKeys.clear();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->running)
+                break;
+            for (auto fd : this->closing) close(fd);
+            this->closing.clear();
+
+            fds.push_back(pollfd{this->wakeFd, POLLIN, 0});
+            for (auto &e : this->entries)
+            {
+                if (e.fd < 0 && !e.path.empty())
+                {
+                    //reading the file once arms sysfs notification
+                    std::string value;
+                    e.fd = open(e.path.c_str(), O_RDONLY | O_CLOEXEC);
+                    if (e.fd < 0 || !readSysfs(e.fd, value))
+                    {
+                        if (e.fd >= 0) close(e.fd);
+                        e.fd = -1;
+                        e.path.clear();
+                    }
+                }
+                if (e.fd < 0)
+                    continue;
+                fds.push_back(pollfd{e.fd, POLLPRI, 0});
+                fdKeys.push_back(e.key);
+            }
+        }
+
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextRead - Clock::now()).count();
+        if (poll(fds.data(), fds.size(), std::max<int>(0, int(wait))) < 0 && errno != EINTR)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            uint64_t count;
+            if (read(this->wakeFd, &count, sizeof(count)) < 0) {}
+        }
+
+        changes.clear();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            //attributes whose drivers notify
+            for (size_t i = 1; i < fds.size(); i++)
+            {
+                if ((fds[i].revents & (POLLPRI | POLLERR)) == 0)
+                    continue;
+                for (auto &e : this->entries)
+                {
+                    std::string value;
+                    if (e.key != fdKeys[i - 1] || e.fd != fds[i].fd || !readSysfs(e.fd, value))
+                        continue;
+                    e.notifies = true;
+                    if (value != e.value)
+                    {
+                        e.value = value;
+                        changes.push_back(std::make_pair(e.key, value));
+                    }
+                }
+            }
+        }
+
+        //bulk reads may be remote round trips, so they are made outside the
+        //lock, leaving watch() and unwatch() free to change the entries
+        if (Clock::now() >= nextRead)
+        {
+            std::vector<std::shared_ptr<Group>> groups;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                for (const auto &e : this->entries)
+                {
+                    if (!e.notifies && std::find(groups.begin(), groups.end(), e.group) == groups.end())
+                        groups.push_back(e.group);
+                }
+            }
+            std::vector<std::vector<std::pair<std::string, std::string>>> results;
+            for (const auto &group : groups) results.push_back(group->values());
+
+            bool changed = false;
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                for (size_t i = 0; i < groups.size(); i++)
+                {
+                    for (auto &e : this->entries)
+                    {
+                        if (e.notifies || e.group != groups[i])
+                            continue;
+                        for (const auto &v : results[i])
+                        {
+                            if (v.first != e.name || v.second == e.value)
+                                continue;
+                            e.value = v.second;
+                            changes.push_back(std::make_pair(e.key, v.second));
+                            changed = true;
+                        }
+                    }
+                }
+            }
+            interval = changed ? MIN_INTERVAL_MS : std::min(interval * 2, int(MAX_INTERVAL_MS));
+            nextRead = Clock::now() + std::chrono::milliseconds(interval);
+        }
+
+        for (const auto &c : changes)
+        {
+            try
+            {
+                this->callback(c.first, c.second);
+            }
+            catch (const std::exception &) {}
+        }
+    }
+}
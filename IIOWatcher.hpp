@@ -0,0 +1,87 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "IIOSupport.hpp"
+
+/*!
+ * IIOAttrWatcher monitors a set of attributes from a background thread and
+ * reports their values when they change.
+ *
+ * Each attribute file is polled for POLLPRI, which sysfs raises when the
+ * driver calls sysfs_notify(). Until an attribute has shown that its driver
+ * notifies, it is also re-read periodically, with the attributes of each
+ * device or channel fetched in one bulk read. The read interval starts short,
+ * and doubles each time nothing has changed, up to a limit.
+ *
+ * Changes seen together are coalesced, so that the callback is only invoked
+ * once per attribute, and only when the value differs from the last value
+ * reported.
+ */
+class IIOAttrWatcher
+{
+public:
+    typedef std::function<void(const std::string &key, const std::string &value)> Callback;
+
+    static const int MIN_INTERVAL_MS = 100;
+    static const int MAX_INTERVAL_MS = 2000;
+
+    IIOAttrWatcher(const Callback &callback);
+    ~IIOAttrWatcher(void);
+
+    /*!
+     * Watch the named attribute, reporting changes under the given key.
+     * The watcher thread is started by the first call.
+     */
+    template <class T>
+    void watch(const std::string &key, IIOAttrs<T> attrs, const std::string &name);
+
+    /*!
+     * Stop watching the attribute reported under the given key.
+     */
+    void unwatch(const std::string &key);
+
+    /*!
+     * Get the keys of all watched attributes.
+     */
+    std::vector<std::string> watched(void);
+
+private:
+    //the attributes of one device or channel, which are read together
+    struct Group
+    {
+        virtual ~Group(void) {}
+        virtual std::vector<std::pair<std::string, std::string>> values(void) = 0;
+    };
+    template <class T>
+    struct AttrGroup;
+
+    struct Entry
+    {
+        std::string key;
+        std::string name;
+        std::string path;
+        std::shared_ptr<Group> group;
+        std::string value;
+        int fd;
+        bool notifies;
+    };
+
+    Callback callback;
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<int> closing;
+    std::thread thread;
+    int wakeFd;
+    bool running;
+
+    void wake(void);
+    void run(void);
+};
@@ -0,0 +1,63 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IIOCalibration.hpp"
+
+#include <json.hpp>
+using json = nlohmann::json;
+
+/***********************************************************************
+ * Run a small calibration sweep on the input scan elements of iio_dummy,
+ * loaded with its buffer support and a trigger (see README.md), and check
+ * the shape of the result.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_calibration_dummy)
+{
+    auto &ctx = IIOContext::get();
+    std::unique_ptr<IIODevice> dev;
+    for (auto d : ctx.devices())
+    {
+        if (d.name() == "iio_dummy_part_no") dev.reset(new IIODevice(d));
+    }
+    if (!dev)
+    {
+        std::cout << "iio_dummy is not loaded, skipping" << std::endl;
+        return;
+    }
+    std::vector<IIOChannel> channels;
+    for (auto c : dev->channels())
+    {
+        if (!c.isOutput() && c.isScanElement()) channels.push_back(c);
+    }
+    if (channels.empty())
+    {
+        std::cout << "iio_dummy has no buffer support, skipping" << std::endl;
+        return;
+    }
+
+    //a stalled trigger fails transfers instead of hanging the test
+    ctx.setTimeout(1000);
+
+    IIOCalibration calibration;
+    calibration.bufferSizes = {64, 256};
+    calibration.bufferCounts = {2};
+    calibration.burstSeconds = 0.05;
+    const auto result = json::parse(calibration.run(*dev, channels, 0.0));
+    std::cout << result.dump(4) << std::endl;
+
+    POTHOS_TEST_EQUAL(result["direction"].get<std::string>(), "input");
+    POTHOS_TEST_EQUAL(result["points"].size(), size_t(4));
+    POTHOS_TEST_TRUE(!result["xrunsMeasured"].get<bool>());
+    for (const auto &p : result["points"])
+    {
+        POTHOS_TEST_TRUE(p.count("estimatedOverrunsPerSecond") == 1);
+        POTHOS_TEST_TRUE(p.count("overruns") == 0);
+        POTHOS_TEST_TRUE(p["sampleRate"].get<double>() >= 0.0);
+    }
+    POTHOS_TEST_TRUE(result.count("recommended") == 1);
+}
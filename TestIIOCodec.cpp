@@ -0,0 +1,173 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <Poco/TemporaryFile.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "IIOCodec.hpp"
+
+//scans of an 8-bit, a big-endian 16-bit, a 32-bit and a 64-bit channel,
+//with unused bytes after the 8-bit channel which decode as zeros
+static const size_t TEST_STEP = 16;
+
+static std::vector<IIOCodecChannel> testChannels(void)
+{
+    std::vector<IIOCodecChannel> channels(4);
+    channels[0] = {"voltage0", 0, 8, 8, 0, true, false};
+    channels[1] = {"voltage1", 2, 16, 12, 4, true, true};
+    channels[2] = {"voltage2", 4, 32, 32, 0, false, false};
+    channels[3] = {"timestamp", 8, 64, 64, 0, false, false};
+    return channels;
+}
+
+static void putSample(uint8_t *p, uint64_t value, size_t size, bool bigEndian)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        p[bigEndian ? size - 1 - i : i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+//scans which pack well: the 8-bit channel is silent, so its groups have a
+//width of zero, the others change slowly, except for the first group of the
+//64-bit channel which swings across its whole range and needs a width of 64
+static std::vector<uint8_t> quietScans(size_t count, size_t first)
+{
+    std::vector<uint8_t> scans(count * TEST_STEP, 0);
+    for (size_t n = 0; n < count; n++)
+    {
+        const size_t k = first + n;
+        uint8_t *scan = &scans[n * TEST_STEP];
+        putSample(scan + 2, static_cast<uint64_t>(-100 + int(k % 200)) << 4, 2, true);
+        putSample(scan + 4, 0xfffff000 + k * 3, 4, false);
+        const uint64_t timestamp = (k < IIOBlockCodec::GROUP_SIZE) ?
+            ((k % 2) ? 0x8000000000000000ull : 0) : 1000000000000ull + k * 125;
+        putSample(scan + 8, timestamp, 8, false);
+    }
+    return scans;
+}
+
+//scans which do not pack at all
+static std::vector<uint8_t> noisyScans(size_t count, uint64_t seed)
+{
+    std::vector<uint8_t> scans(count * TEST_STEP, 0);
+    for (size_t n = 0; n < count; n++)
+    {
+        uint8_t *scan = &scans[n * TEST_STEP];
+        for (size_t i = 0; i < TEST_STEP; i++)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            if (i != 1 && i != 3) scan[i] = static_cast<uint8_t>(seed >> 56);
+        }
+    }
+    return scans;
+}
+
+static std::vector<uint8_t> readFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/***********************************************************************
+ * Encode and decode multi-channel blocks with IIOBlockCodec, including
+ * groups of width 0 and 64, a partial last group, and blocks which fall
+ * back to raw samples.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_codec_round_trip)
+{
+    IIOBlockCodec codec(testChannels(), TEST_STEP);
+    std::vector<uint8_t> encoded;
+
+    for (const size_t count : {size_t(1), size_t(32), size_t(100)})
+    {
+        const auto scans = quietScans(count, 0);
+        POTHOS_TEST_TRUE(codec.encode(scans.data(), count, encoded));
+        POTHOS_TEST_TRUE(encoded.size() < scans.size());
+
+        std::vector<uint8_t> decoded(scans.size(), 0xff);
+        codec.decode(encoded.data(), encoded.size(), count, decoded.data());
+        POTHOS_TEST_TRUE(decoded == scans);
+
+        //every group of the silent channel is a lone zero width
+        const size_t groups = (count + IIOBlockCodec::GROUP_SIZE - 1) / IIOBlockCodec::GROUP_SIZE;
+        for (size_t g = 0; g < groups; g++) POTHOS_TEST_EQUAL(encoded[g], uint8_t(0));
+
+        POTHOS_TEST_THROWS(codec.decode(encoded.data(), encoded.size() - 1, count, decoded.data()),
+            Pothos::DataFormatException);
+    }
+
+    const auto noise = noisyScans(100, 1);
+    POTHOS_TEST_TRUE(!codec.encode(noise.data(), 100, encoded));
+    POTHOS_TEST_TRUE(encoded.empty());
+}
+
+/***********************************************************************
+ * Record packed and raw blocks, read them back through the index, then
+ * cut the recording short inside its last block and check that the
+ * blocks before it are found again by scanning.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_codec_recording)
+{
+    const std::string path = Poco::TemporaryFile::tempName();
+    const std::vector<size_t> counts = {100, 64, 100, 40};
+    std::vector<std::vector<uint8_t>> blocks;
+    {
+        IIORecordWriter writer(path, testChannels(), TEST_STEP, 1e6, true);
+        uint64_t sampleIndex = 0;
+        for (size_t b = 0; b < counts.size(); b++)
+        {
+            blocks.push_back((b % 2) ? noisyScans(counts[b], b) : quietScans(counts[b], sampleIndex));
+            writer.write(blocks.back().data(), counts[b], sampleIndex, 1000 + b);
+            sampleIndex += counts[b];
+        }
+        writer.close();
+    }
+
+    auto check = [&](IIORecordReader &reader, size_t numBlocks)
+    {
+        POTHOS_TEST_EQUAL(reader.step(), TEST_STEP);
+        POTHOS_TEST_EQUAL(reader.sampleRate(), 1e6);
+        POTHOS_TEST_EQUAL(reader.channels().size(), size_t(4));
+        POTHOS_TEST_TRUE(reader.channels()[1].isBigEndian);
+        POTHOS_TEST_EQUAL(reader.channels()[1].shift, 4u);
+        POTHOS_TEST_EQUAL(reader.blocks().size(), numBlocks);
+        uint64_t sampleIndex = 0;
+        std::vector<uint8_t> scans;
+        for (size_t b = 0; b < numBlocks; b++)
+        {
+            POTHOS_TEST_EQUAL(reader.blocks()[b].sampleIndex, sampleIndex);
+            POTHOS_TEST_EQUAL(reader.blocks()[b].timestamp, int64_t(1000 + b));
+            POTHOS_TEST_EQUAL(reader.find(sampleIndex + counts[b] - 1), b);
+            POTHOS_TEST_EQUAL(reader.read(b, scans), counts[b]);
+            POTHOS_TEST_TRUE(scans == blocks[b]);
+            sampleIndex += counts[b];
+        }
+    };
+
+    std::vector<uint64_t> offsets;
+    {
+        IIORecordReader reader(path);
+        check(reader, counts.size());
+        for (const auto &b : reader.blocks()) offsets.push_back(b.fileOffset);
+    }
+
+    //drop the index and all but the header and first bytes of the last block
+    auto data = readFile(path);
+    data.resize(offsets.back() + 40);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    }
+    {
+        IIORecordReader reader(path);
+        check(reader, counts.size() - 1);
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Framework.hpp>
+#include <Pothos/Testing.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int TEST_PORT = 17399;
+
+//a packet as produced by the IIO source in "PACKET" mode, with two 16-bit
+//channels "a" and "b" interleaved
+static Pothos::Packet makePacket(size_t scans, unsigned long long sampleIndex)
+{
+    Pothos::Packet packet;
+    packet.payload = Pothos::BufferChunk(Pothos::DType(typeid(int16_t)), scans * 2);
+    auto samples = packet.payload.as<int16_t *>();
+    for (size_t n = 0; n < scans; n++)
+    {
+        samples[2 * n + 0] = static_cast<int16_t>((sampleIndex + n) % 30000);
+        samples[2 * n + 1] = static_cast<int16_t>(-static_cast<int>((sampleIndex + n) % 30000));
+    }
+    packet.metadata["channels"] = Pothos::Object(std::vector<std::string>{"a", "b"});
+    packet.metadata["offsets"] = Pothos::Object(std::vector<size_t>{0, 2});
+    packet.metadata["sizes"] = Pothos::Object(std::vector<size_t>{2, 2});
+    packet.metadata["step"] = Pothos::Object(size_t(4));
+    packet.metadata["sampleIndex"] = Pothos::Object(sampleIndex);
+    packet.metadata["timestamp"] = Pothos::Object(0ll);
+    packet.metadata["overflow"] = Pothos::Object(false);
+    return packet;
+}
+
+/***********************************************************************
+ * Stream frames from the network sink to the network source over the
+ * loopback interface, including a frame much larger than the output
+ * buffers of the source, and check that the channels come out intact.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_net_loopback)
+{
+    auto feeder = Pothos::BlockRegistry::make("/blocks/feeder_source", "int16");
+    auto netSink = Pothos::BlockRegistry::make("/iio/netsink", "127.0.0.1", TEST_PORT);
+    auto netSource = Pothos::BlockRegistry::make("/iio/netsource", "127.0.0.1", TEST_PORT,
+        std::vector<std::string>{"a", "b"}, Pothos::DType(typeid(int16_t)));
+    auto collectorA = Pothos::BlockRegistry::make("/blocks/collector_sink", "int16");
+    auto collectorB = Pothos::BlockRegistry::make("/blocks/collector_sink", "int16");
+
+    //the server listens before the client connects
+    Pothos::Topology server;
+    server.connect(feeder, 0, netSink, 0);
+    server.commit();
+    Pothos::Topology client;
+    client.connect(netSource, "a", collectorA, 0);
+    client.connect(netSource, "b", collectorB, 0);
+    client.commit();
+
+    const std::vector<size_t> sizes{100, 100000, 1000};
+    size_t total = 0;
+    for (const auto size : sizes)
+    {
+        feeder.call("feedPacket", makePacket(size, total));
+        total += size;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    Pothos::BufferChunk a, b;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        a = collectorA.call<Pothos::BufferChunk>("getBuffer");
+        b = collectorB.call<Pothos::BufferChunk>("getBuffer");
+        if (a.elements() >= total && b.elements() >= total)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    POTHOS_TEST_EQUAL(a.elements(), total);
+    POTHOS_TEST_EQUAL(b.elements(), total);
+    for (size_t n = 0; n < total; n++)
+    {
+        POTHOS_TEST_EQUAL(a.as<const int16_t *>()[n], static_cast<int16_t>(n % 30000));
+        POTHOS_TEST_EQUAL(b.as<const int16_t *>()[n], static_cast<int16_t>(-static_cast<int>(n % 30000)));
+    }
+    POTHOS_TEST_EQUAL(netSink.call<unsigned long long>("droppedFrames"), 0ull);
+}
+
+/***********************************************************************
+ * A client which never reads must not stall the network sink; its frames
+ * are dropped instead.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_net_slow_client)
+{
+    auto feeder = Pothos::BlockRegistry::make("/blocks/feeder_source", "int16");
+    auto netSink = Pothos::BlockRegistry::make("/iio/netsink", "127.0.0.1", TEST_PORT);
+    Pothos::Topology server;
+    server.connect(feeder, 0, netSink, 0);
+    server.commit();
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    POTHOS_TEST_TRUE(fd >= 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    POTHOS_TEST_EQUAL(connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)), 0);
+
+    //far more than the socket buffers and the backlog hold
+    for (size_t i = 0; i < 64; i++)
+    {
+        feeder.call("feedPacket", makePacket(100000, i * 100000));
+    }
+    POTHOS_TEST_TRUE(server.waitInactive(0.1, 10.0));
+    POTHOS_TEST_TRUE(netSink.call<unsigned long long>("droppedFrames") > 0);
+    close(fd);
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IIOSupport.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t BLOCK_SAMPLES = 1024;
+static const size_t BLOCKS = 16;
+
+//run a number of refills, spending the given time processing each block
+static double timeRefills(IIOBuffer &buf, std::chrono::microseconds processing)
+{
+    const auto start = Clock::now();
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        POTHOS_TEST_EQUAL(buf.refill(), BLOCK_SAMPLES * size_t(buf.step()));
+        std::this_thread::sleep_for(processing);
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/***********************************************************************
+ * Run against iiod on the local machine, through POTHOS_IIO_CONTEXT_URI
+ * (see README.md for adding delay to the loopback interface), streaming
+ * from the first device with input scan elements, such as iio_dummy.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_remote_context)
+{
+    if (std::getenv("POTHOS_IIO_CONTEXT_URI") == nullptr)
+    {
+        std::cout << "POTHOS_IIO_CONTEXT_URI is not set, skipping" << std::endl;
+        return;
+    }
+    auto &ctx = IIOContext::get();
+    POTHOS_TEST_TRUE(ctx.remote());
+
+    std::unique_ptr<IIODevice> dev;
+    for (auto d : ctx.devices())
+    {
+        for (auto c : d.channels())
+        {
+            if (!c.isOutput() && c.isScanElement())
+            {
+                c.enable();
+                dev.reset(new IIODevice(d));
+            }
+        }
+        if (dev) break;
+    }
+    if (!dev)
+    {
+        std::cout << "no device with input scan elements, skipping" << std::endl;
+        return;
+    }
+
+    //prefetched attribute reads match direct ones, for the attributes which
+    //do not change between two direct reads (unlike sensor readings)
+    ctx.setAttributePrefetch(0);
+    const auto first = dev->attributes().values();
+    const auto second = dev->attributes().values();
+    const std::map<std::string, std::string> again(second.begin(), second.end());
+    std::map<std::string, std::string> stable;
+    for (const auto &v : first)
+    {
+        auto it = again.find(v.first);
+        if (it != again.end() && it->second == v.second) stable.insert(v);
+    }
+    ctx.setAttributePrefetch(1000);
+    for (const auto &v : stable)
+    {
+        POTHOS_TEST_EQUAL(dev->attributes().at(v.first).value(), v.second);
+    }
+
+    //measure the round trip of a plain refill
+    double roundTrip;
+    {
+        IIOBuffer buf(dev->createBuffer(BLOCK_SAMPLES, false));
+        POTHOS_TEST_EQUAL(buf.pipelineDepth(), size_t(0));
+        buf.refill();
+        roundTrip = timeRefills(buf, std::chrono::microseconds(0)) / BLOCKS;
+    }
+    std::cout << "refill round trip " << roundTrip * 1e3 << " ms" << std::endl;
+
+    //processing for as long as a round trip takes, pipelined refills
+    //should take up to half the time of plain ones
+    const std::chrono::microseconds processing(static_cast<long long>(roundTrip * 1e6));
+    double plain, pipelined;
+    {
+        IIOBuffer buf(dev->createBuffer(BLOCK_SAMPLES, false));
+        buf.refill();
+        plain = timeRefills(buf, processing);
+    }
+    {
+        IIOBuffer buf(dev->createBuffer(BLOCK_SAMPLES, false));
+        buf.setPipelineDepth(3);
+        POTHOS_TEST_EQUAL(buf.pipelineDepth(), size_t(3));
+        buf.refill();
+        pipelined = timeRefills(buf, processing);
+    }
+    std::cout << "plain " << plain << " s, pipelined " << pipelined << " s" << std::endl;
+
+    //only compare when delay was added, since local round trips are too
+    //short to measure reliably
+    if (roundTrip >= 0.005)
+    {
+        POTHOS_TEST_TRUE(pipelined < 0.8 * plain);
+    }
+
+    //destroying a buffer with a refill outstanding must not hang
+    {
+        IIOBuffer buf(dev->createBuffer(BLOCK_SAMPLES, false));
+        buf.setPipelineDepth(2);
+        buf.refill();
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2026 PothosIIO contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <Pothos/Testing.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "IIOVrt.hpp"
+
+static const int TEST_VRT_PORT = 17400;
+static const char *TEST_VRT_GROUP = "239.255.49.1";
+static const uint32_t TEST_STREAM_ID = 0x1234abcd;
+
+//scans of two little-endian 16-bit fields, one little-endian 32-bit field
+//and one big-endian 16-bit field, which leave two bytes of padding when
+//seven scans are packed into a packet
+static const size_t TEST_STEP = 10;
+static const size_t TEST_SCANS_PER_PACKET = 7;
+
+static void putBytes(uint8_t *p, uint32_t value, size_t size, bool bigEndian)
+{
+    for (size_t k = 0; k < size; k++)
+    {
+        const uint8_t byte = static_cast<uint8_t>(value >> (8 * k));
+        p[bigEndian ? size - 1 - k : k] = byte;
+    }
+}
+
+//the scan as produced by the device, and as expected in the VRT payload
+static void makeScan(size_t n, uint8_t *scan, uint8_t *expected)
+{
+    const uint32_t values[4] = {
+        static_cast<uint32_t>(n * 3 + 1), static_cast<uint32_t>(0x8000 | n),
+        static_cast<uint32_t>(0x01020304 + n * 0x01010101), static_cast<uint32_t>(0x4000 + n)};
+    const size_t offsets[4] = {0, 2, 4, 8};
+    const size_t sizes[4] = {2, 2, 4, 2};
+    for (size_t i = 0; i < 4; i++)
+    {
+        putBytes(scan + offsets[i], values[i], sizes[i], i == 3);
+        putBytes(expected + offsets[i], values[i], sizes[i], true);
+    }
+}
+
+static uint32_t getWord(const std::vector<uint8_t> &packet, size_t word)
+{
+    uint32_t value;
+    std::copy(packet.begin() + word * 4, packet.begin() + word * 4 + 4, reinterpret_cast<uint8_t *>(&value));
+    return ntohl(value);
+}
+
+/***********************************************************************
+ * Send blocks of scans to a multicast group joined on the loopback
+ * interface, and check the header, packet count, timestamps and
+ * byte-swapped payload of every data packet received.
+ **********************************************************************/
+POTHOS_TEST_BLOCK("/iio/tests", test_vrt_multicast)
+{
+    const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    POTHOS_TEST_TRUE(sock >= 0);
+    const int one = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_VRT_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    POTHOS_TEST_EQUAL(bind(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)), 0);
+    struct timeval timeout = {1, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct ip_mreq mreq = {};
+    inet_pton(AF_INET, TEST_VRT_GROUP, &mreq.imr_multiaddr);
+    mreq.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+    if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    {
+        std::cout << "cannot join a multicast group on loopback, skipping" << std::endl;
+        ::close(sock);
+        return;
+    }
+
+    IIOVrtSender sender;
+    sender.open(TEST_VRT_GROUP, TEST_VRT_PORT, TEST_STREAM_ID, "127.0.0.1");
+    sender.setLayout({{0, 2, false}, {2, 2, false}, {4, 4, false}, {8, 2, true}}, TEST_STEP);
+    sender.setPayloadSize(TEST_SCANS_PER_PACKET * TEST_STEP + 5);
+
+    //two blocks of 15 packets each, so that the packet count wraps
+    const size_t blockScans = 100;
+    const double sampleRate = 1e6;
+    const long long blockTimes[2] = {1700000000999950000ll, 1700000001000100000ll};
+    std::vector<uint8_t> scans(2 * blockScans * TEST_STEP), expected(scans.size());
+    for (size_t n = 0; n < 2 * blockScans; n++)
+    {
+        makeScan(n, &scans[n * TEST_STEP], &expected[n * TEST_STEP]);
+    }
+    for (size_t b = 0; b < 2; b++)
+    {
+        sender.sendData(&scans[b * blockScans * TEST_STEP], blockScans, blockTimes[b], sampleRate);
+    }
+    const size_t packetsPerBlock = (blockScans + TEST_SCANS_PER_PACKET - 1) / TEST_SCANS_PER_PACKET;
+    POTHOS_TEST_EQUAL(sender.packetsSent(), 2 * packetsPerBlock);
+
+    std::vector<uint8_t> packet(65536);
+    for (size_t p = 0; p < 2 * packetsPerBlock; p++)
+    {
+        const ssize_t ret = recv(sock, packet.data(), packet.size(), 0);
+        if (ret < 0 && p == 0)
+        {
+            std::cout << "no multicast packets on loopback, skipping" << std::endl;
+            ::close(sock);
+            return;
+        }
+        POTHOS_TEST_TRUE(ret > 0);
+        POTHOS_TEST_EQUAL(size_t(ret) % 4, size_t(0));
+        const size_t packetWords = size_t(ret) / 4;
+        POTHOS_TEST_TRUE(packetWords > 5);
+
+        //IF data with stream ID, UTC and real-time timestamps
+        const uint32_t header = getWord(packet, 0);
+        POTHOS_TEST_EQUAL(header >> 28, uint32_t(1));
+        POTHOS_TEST_EQUAL((header >> 22) & 0x3, uint32_t(1));
+        POTHOS_TEST_EQUAL((header >> 20) & 0x3, uint32_t(2));
+        POTHOS_TEST_EQUAL((header >> 16) & 0xf, uint32_t(p % 16));
+        POTHOS_TEST_EQUAL(header & 0xffff, uint32_t(packetWords));
+        POTHOS_TEST_EQUAL(getWord(packet, 1), TEST_STREAM_ID);
+
+        const size_t b = p / packetsPerBlock;
+        const size_t first = (p % packetsPerBlock) * TEST_SCANS_PER_PACKET;
+        const long long timeNs = blockTimes[b] + static_cast<long long>(first * 1000);
+        const uint64_t picos = (uint64_t(getWord(packet, 3)) << 32) | getWord(packet, 4);
+        POTHOS_TEST_EQUAL(getWord(packet, 2), uint32_t(timeNs / 1000000000));
+        POTHOS_TEST_EQUAL(picos, uint64_t(timeNs % 1000000000) * 1000);
+
+        //whole scans in network byte order, padded to a whole word
+        const size_t count = std::min(TEST_SCANS_PER_PACKET, blockScans - first);
+        const size_t bytes = count * TEST_STEP;
+        POTHOS_TEST_EQUAL(packetWords, 5 + (bytes + 3) / 4);
+        const size_t offset = (b * blockScans + first) * TEST_STEP;
+        POTHOS_TEST_TRUE(std::equal(packet.begin() + 20, packet.begin() + 20 + bytes, expected.begin() + offset));
+        for (size_t i = 20 + bytes; i < size_t(ret); i++) POTHOS_TEST_EQUAL(packet[i], uint8_t(0));
+    }
+    ::close(sock);
+}